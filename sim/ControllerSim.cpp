@@ -0,0 +1,169 @@
+#include "ControllerSim.h"
+
+static const float ambientC = 25.0f;
+static const float heaterCPerSPerPct = 0.02f;  // heating rate per % output
+static const float lossTauS = 200.0f;          // time constant of losses to ambient
+static const float integralLimit = 500.0f;
+static const unsigned long plantStepMs = 100;
+static const size_t historyLength = 3600;
+
+ControllerSim::ControllerSim(uint32_t uptimeS) : history(historyLength) {
+    state.currentTemp = lastTemp = ambientC;
+    state.setpoint = 80.0f;
+    state.kp = 4.0f; state.ki = 0.1f; state.kd = 1.0f;
+    state.isRunning = 1;
+    offsetMs = uptimeS * 1000;
+    // The test was started by a dial that has rebooted since, with seq 1
+    ack.seq = 1;
+    ack.status = CMD_OK;
+    while (clockMs < offsetMs) {
+        if (state.isRunning && clockMs + 60000 >= offsetMs) state.isRunning = 0;
+        stepPlant(plantStepMs / 1000.0f);
+    }
+    for (int f = 0; f < CF_COUNT; f++) encodeField(state, (ControllerField)f, shown + controllerFields[f].offset);
+}
+
+void ControllerSim::stepPlant(float dt) {
+    float temp = state.currentTemp;
+    if (state.isRunning) {
+        float err = state.setpoint - temp;
+        integral = constrain(integral + err * dt, -integralLimit, integralLimit);
+        float out = state.kp * err + state.ki * integral - state.kd * (temp - lastTemp) / dt;
+        state.output = constrain(out, 0.0f, 100.0f);
+        state.testDuration = (clockMs - runStartMs) / 1000;
+    } else {
+        integral = 0;
+        state.output = 0;
+    }
+    lastTemp = temp;
+    state.currentTemp = temp + dt * (heaterCPerSPerPct * state.output - (temp - ambientC) / lossTauS);
+
+    clockMs += (unsigned long)(dt * 1000);
+    if (clockMs / 1000 > samples) {
+        HistorySample &s = history[samples % historyLength];
+        s.temp = (int16_t)lroundf(state.currentTemp * 10);
+        s.output = (int16_t)lroundf(state.output * 10);
+        samples++;
+    }
+}
+
+void ControllerSim::update() {
+    unsigned long target = millis() + offsetMs;
+    while (clockMs + plantStepMs <= target) stepPlant(plantStepMs / 1000.0f);
+
+    uint8_t now[CONTROLLER_WIRE_SIZE];
+    for (int f = 0; f < CF_COUNT; f++) {
+        const ControllerFieldInfo &info = controllerFields[f];
+        encodeField(state, (ControllerField)f, now + info.offset);
+        if (memcmp(now + info.offset, shown + info.offset, info.size) != 0) changed |= 1 << f;
+    }
+    memcpy(shown, now, sizeof(shown));
+}
+
+// A frame the dial wrote: either a write, or the request half of a read.
+bool ControllerSim::receive(const uint8_t *data, size_t len) {
+    update();
+    if (len == 0) return true;      // address probe
+    FrameHeader h;
+    if (len < FRAME_OVERHEAD) { framesDropped++; return true; }
+    memcpy(&h, data, sizeof(h));
+    size_t n = (h.reg & FRAME_READ) ? 0 : h.len;
+    uint16_t crc = data[len - 2] | (data[len - 1] << 8);
+    if (h.version != CONTROLLER_PROTOCOL_VERSION || len != n + FRAME_OVERHEAD ||
+        crc != frameCrc(data, len - 2) || h.len > FRAME_MAX_PAYLOAD) {
+        framesDropped++;
+        readPending = false;
+        return true;
+    }
+    if (h.reg & FRAME_READ) {
+        readHeader = h;
+        readHeader.reg &= ~FRAME_READ;
+        readPending = true;
+    } else {
+        writeRegister(h.reg, data + sizeof(h), n);
+    }
+    return true;
+}
+
+size_t ControllerSim::request(uint8_t *buf, size_t len) {
+    if (!readPending) {
+        memset(buf, 0xFF, len);     // idle bus
+        return len;
+    }
+    readPending = false;
+    uint8_t frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    size_t n = readHeader.len;
+    memcpy(frame, &readHeader, sizeof(readHeader));
+    readRegister(readHeader.reg, frame + sizeof(readHeader), n);
+    uint16_t crc = frameCrc(frame, sizeof(readHeader) + n);
+    frame[sizeof(readHeader) + n] = crc;
+    frame[sizeof(readHeader) + n + 1] = crc >> 8;
+    size_t total = std::min(len, n + FRAME_OVERHEAD);
+    memcpy(buf, frame, total);
+    return total;
+}
+
+void ControllerSim::readRegister(uint8_t reg, uint8_t *out, size_t n) {
+    uint8_t reply[FRAME_MAX_PAYLOAD] = {};
+    if (reg == REG_VERSION) {
+        reply[0] = CONTROLLER_PROTOCOL_VERSION;
+    } else if (reg == REG_CHANGED) {
+        putLe16(reply, changed);
+        changed = 0;
+    } else if (reg == REG_ACK) {
+        encodeAck(ack, reply);
+    } else if (reg >= REG_DATA && reg < REG_DATA + CONTROLLER_WIRE_SIZE) {
+        memcpy(reply, shown + (reg - REG_DATA), std::min(n, (size_t)(REG_DATA + CONTROLLER_WIRE_SIZE - reg)));
+    } else if (reg == REG_HISTORY_INFO) {
+        HistoryInfo info = { samples - 1, (uint16_t)std::min(samples, (uint32_t)historyLength) };
+        encodeHistoryInfo(info, reply);
+    } else if (reg == REG_HISTORY) {
+        uint32_t oldest = samples > historyLength ? samples - historyLength : 0;
+        uint32_t first = std::max(historySelect, oldest);
+        putLe32(reply, first);
+        for (size_t i = 0; 4 + (i + 1) * HISTORY_SAMPLE_WIRE_SIZE <= n && first + i < samples; i++) {
+            encodeHistorySample(history[(first + i) % historyLength], reply + 4 + i * HISTORY_SAMPLE_WIRE_SIZE);
+        }
+    }
+    memcpy(out, reply, n);
+}
+
+void ControllerSim::writeRegister(uint8_t reg, const uint8_t *p, size_t n) {
+    if (reg == REG_COMMAND && n >= 2) {
+        if (p[0] == ack.seq) return;    // a resend of the last command
+        ack.seq = p[0];
+        ack.status = applyCommand(p[1], p + 2, n - 2);
+        update();
+    } else if (reg == REG_HISTORY_SELECT && n == 4) {
+        historySelect = getLe32(p);
+    }
+}
+
+uint8_t ControllerSim::applyCommand(uint8_t type, const uint8_t *args, size_t n) {
+    if (type < CMD_SET_SETPOINT || type > CMD_STOP_TEST) return CMD_UNKNOWN;
+    if (n != 4 * (size_t)commandArgCount(type)) return CMD_REJECTED;
+    switch (type) {
+        case CMD_SET_SETPOINT: {
+            float sp = getLeFloat(args);
+            if (sp < 0 || sp > 250) return CMD_REJECTED;
+            state.setpoint = sp;
+            break;
+        }
+        case CMD_SET_GAINS:
+            state.kp = getLeFloat(args);
+            state.ki = getLeFloat(args + 4);
+            state.kd = getLeFloat(args + 8);
+            break;
+        case CMD_START_TEST:
+            if (state.errorState) return CMD_REJECTED;
+            state.isRunning = 1;
+            state.testDuration = 0;
+            runStartMs = clockMs;
+            break;
+        case CMD_STOP_TEST:
+            state.isRunning = 0;
+            break;
+    }
+    commandsApplied++;
+    return CMD_OK;
+}
@@ -0,0 +1,52 @@
+// Stand-in for the oven mainboard: the slave side of the protocol in
+// src/SharedData.h (framing, register map, commands, history) on top of a
+// first-order thermal plant driven by a PID. Attach it to the Wire stub.
+#ifndef SIM_CONTROLLER_SIM_H
+#define SIM_CONTROLLER_SIM_H
+
+#include <Wire.h>
+#include <vector>
+#include "../src/SharedData.h"
+
+class ControllerSim : public SimI2cDevice {
+public:
+    // The mainboard has been up for uptimeS seconds, all but the last
+    // minute of it running a test, so there is history to download; more
+    // of it than the finest tier of the dial's log holds.
+    explicit ControllerSim(uint32_t uptimeS = 1200);
+
+    bool receive(const uint8_t *data, size_t len) override;
+    size_t request(uint8_t *buf, size_t len) override;
+
+    // Runs the plant up to the current millis() and flags changed fields.
+    // Call after editing `state` from a script.
+    void update();
+
+    ControllerData state = {};
+    unsigned long framesDropped = 0;    // failed version or CRC
+    unsigned long commandsApplied = 0;
+
+private:
+    void stepPlant(float dt);
+    void readRegister(uint8_t reg, uint8_t *out, size_t n);
+    void writeRegister(uint8_t reg, const uint8_t *p, size_t n);
+    uint8_t applyCommand(uint8_t type, const uint8_t *args, size_t n);
+
+    unsigned long clockMs = 0;          // plant time
+    unsigned long offsetMs;             // plant time at millis() == 0
+    unsigned long runStartMs = 0;
+    float integral = 0, lastTemp = 0;
+
+    uint8_t shown[CONTROLLER_WIRE_SIZE] = {};   // fields as of the last update()
+    uint16_t changed = 0;
+    CommandAck ack = {};
+
+    std::vector<HistorySample> history;         // ring, one sample per second
+    uint32_t samples = 0;                       // taken so far
+    uint32_t historySelect = 0;
+
+    bool readPending = false;
+    FrameHeader readHeader = {};
+};
+
+#endif
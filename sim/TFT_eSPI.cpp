@@ -0,0 +1,275 @@
+#include <TFT_eSPI.h>
+
+static uint32_t readInt32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint16_t TFT_eSPI::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc) {
+    uint16_t fgR = ((fgc >> 10) & 0x3E) + 1;
+    uint16_t fgG = ((fgc >> 4) & 0x7E) + 1;
+    uint16_t fgB = ((fgc << 1) & 0x3E) + 1;
+    uint16_t bgR = ((bgc >> 10) & 0x3E) + 1;
+    uint16_t bgG = ((bgc >> 4) & 0x7E) + 1;
+    uint16_t bgB = ((bgc << 1) & 0x3E) + 1;
+    uint16_t r = (((fgR * alpha) + (bgR * (255 - alpha))) >> 9);
+    uint16_t g = (((fgG * alpha) + (bgG * (255 - alpha))) >> 9);
+    uint16_t b = (((fgB * alpha) + (bgB * (255 - alpha))) >> 9);
+    return (r << 11) | (g << 5) | (b << 0);
+}
+
+// ---- smooth fonts ----
+
+void TFT_eSPI::loadFont(const uint8_t array[]) {
+    if (fontLoaded) unloadFont();
+    gFont.gArray = array;
+    gFont.gCount = (uint16_t)readInt32(array);
+    gFont.ascent = (int16_t)readInt32(array + 16);
+    gFont.descent = (int16_t)readInt32(array + 20);
+    gFont.maxAscent = gFont.ascent;
+    gFont.maxDescent = gFont.descent;
+
+    uint16_t n = gFont.gCount;
+    gUnicode = (uint16_t *)malloc(n * 2);
+    gHeight = (uint8_t *)malloc(n);
+    gWidth = (uint8_t *)malloc(n);
+    gxAdvance = (uint8_t *)malloc(n);
+    gdY = (int16_t *)malloc(n * 2);
+    gdX = (int8_t *)malloc(n);
+    gBitmap = (uint32_t *)malloc(n * 4);
+
+    uint32_t bitmapPtr = 24 + (uint32_t)n * 28;
+    for (uint16_t i = 0; i < n; i++) {
+        const uint8_t *g = array + 24 + i * 28;
+        gUnicode[i] = (uint16_t)readInt32(g);
+        gHeight[i] = (uint8_t)readInt32(g + 4);
+        gWidth[i] = (uint8_t)readInt32(g + 8);
+        gxAdvance[i] = (uint8_t)readInt32(g + 12);
+        gdY[i] = (int16_t)readInt32(g + 16);
+        gdX[i] = (int8_t)readInt32(g + 20);
+        if ((gUnicode[i] > 0x20 && gUnicode[i] < 0x7F) || gUnicode[i] == 0xA0) {
+            if (gdY[i] > gFont.maxAscent) gFont.maxAscent = gdY[i];
+            if (gHeight[i] - gdY[i] > gFont.maxDescent) gFont.maxDescent = gHeight[i] - gdY[i];
+        }
+        gBitmap[i] = bitmapPtr;
+        bitmapPtr += gWidth[i] * gHeight[i];
+    }
+    gFont.yAdvance = gFont.maxAscent + gFont.maxDescent;
+    gFont.spaceWidth = (gFont.ascent + gFont.descent) * 2 / 7;
+    fontLoaded = true;
+}
+
+void TFT_eSPI::unloadFont() {
+    free(gUnicode); gUnicode = NULL;
+    free(gHeight); gHeight = NULL;
+    free(gWidth); gWidth = NULL;
+    free(gxAdvance); gxAdvance = NULL;
+    free(gdY); gdY = NULL;
+    free(gdX); gdX = NULL;
+    free(gBitmap); gBitmap = NULL;
+    gFont.gArray = nullptr;
+    fontLoaded = false;
+}
+
+bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index) {
+    for (uint16_t i = 0; i < gFont.gCount; i++) {
+        if (gUnicode[i] == unicode) { *index = i; return true; }
+    }
+    return false;
+}
+
+int16_t TFT_eSPI::fontHeight() {
+    return fontLoaded ? gFont.yAdvance : 8 * textsize;
+}
+
+int16_t TFT_eSPI::textWidth(const char *string) {
+    int16_t w = 0;
+    if (!fontLoaded) return (int16_t)(strlen(string) * 6 * textsize);
+    while (*string) {
+        uint16_t gNum;
+        uint8_t c = (uint8_t)*string++;
+        if (getUnicodeIndex(c, &gNum)) {
+            if (w == 0 && gdX[gNum] < 0) w -= gdX[gNum];
+            if (*string) w += gxAdvance[gNum];
+            else w += gdX[gNum] + gWidth[gNum];
+        } else {
+            w += gFont.spaceWidth + 1;
+        }
+    }
+    return w;
+}
+
+void TFT_eSPI::drawGlyph(uint16_t code) {
+    uint16_t gNum;
+    if (!getUnicodeIndex(code, &gNum)) {
+        if (_fillbg) fillRect(cursor_x, cursor_y, gFont.spaceWidth, gFont.yAdvance, textbgcolor);
+        cursor_x += gFont.spaceWidth;
+        return;
+    }
+    const uint8_t *bmp = gFont.gArray + gBitmap[gNum];
+    int32_t y0 = cursor_y + gFont.maxAscent - gdY[gNum];
+    int32_t x0 = cursor_x + gdX[gNum];
+    if (_fillbg) fillRect(cursor_x, cursor_y, gxAdvance[gNum], gFont.yAdvance, textbgcolor);
+    for (int32_t y = 0; y < gHeight[gNum]; y++) {
+        for (int32_t x = 0; x < gWidth[gNum]; x++) {
+            uint8_t a = bmp[y * gWidth[gNum] + x];
+            if (a == 0) continue;
+            if (a == 255) { drawPixel(x0 + x, y0 + y, textcolor); continue; }
+            uint16_t bg = _fillbg ? textbgcolor : readPixel(x0 + x, y0 + y);
+            drawPixel(x0 + x, y0 + y, alphaBlend(a, textcolor, bg));
+        }
+    }
+    cursor_x += gxAdvance[gNum];
+}
+
+int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY) {
+    int16_t cwidth = textWidth(string);
+    int16_t cheight = fontHeight();
+    switch (textdatum) {
+        case TC_DATUM: poX -= cwidth / 2; break;
+        case TR_DATUM: poX -= cwidth; break;
+        case ML_DATUM: poY -= cheight / 2; break;
+        case MC_DATUM: poX -= cwidth / 2; poY -= cheight / 2; break;
+        case MR_DATUM: poX -= cwidth; poY -= cheight / 2; break;
+        case BL_DATUM: poY -= cheight; break;
+        case BC_DATUM: poX -= cwidth / 2; poY -= cheight; break;
+        case BR_DATUM: poX -= cwidth; poY -= cheight; break;
+    }
+    if (!fontLoaded) return cwidth;  // GLCD fallback font is not emulated
+    cursor_x = poX;
+    cursor_y = poY;
+    while (*string) drawGlyph((uint8_t)*string++);
+    return cwidth;
+}
+
+// ---- viewport & primitives ----
+
+void TFT_eSPI::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum) {
+    _xDatum = x; _yDatum = y;
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > _width) w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w < 0) w = 0;
+    if (h < 0) h = 0;
+    _vpX = x; _vpY = y; _vpW = x + w; _vpH = y + h;
+    _vpDatum = vpDatum;
+    if (!_vpDatum) { _xDatum = 0; _yDatum = 0; }
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    for (int32_t j = 0; j < h; j++)
+        for (int32_t i = 0; i < w; i++) drawPixel(x + i, y + j, color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    for (;;) {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+    for (int32_t y = -r; y <= r; y++)
+        for (int32_t x = -r; x <= r; x++) {
+            int32_t d = x * x + y * y;
+            if (d <= r * r && d > (r - 1) * (r - 1)) drawPixel(x0 + x, y0 + y, color);
+        }
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+    for (int32_t y = -r; y <= r; y++)
+        for (int32_t x = -r; x <= r; x++)
+            if (x * x + y * y <= r * r) drawPixel(x0 + x, y0 + y, color);
+}
+
+static bool inRoundRect(int32_t i, int32_t j, int32_t w, int32_t h, int32_t r) {
+    int32_t cx = i < r ? r - i : (i >= w - r ? i - (w - r - 1) : 0);
+    int32_t cy = j < r ? r - j : (j >= h - r ? j - (h - r - 1) : 0);
+    return cx * cx + cy * cy <= r * r;
+}
+
+void TFT_eSPI::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    for (int32_t j = 0; j < h; j++)
+        for (int32_t i = 0; i < w; i++)
+            if (inRoundRect(i, j, w, h, r)) drawPixel(x + i, y + j, color);
+}
+
+void TFT_eSPI::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    for (int32_t j = 0; j < h; j++)
+        for (int32_t i = 0; i < w; i++)
+            if (inRoundRect(i, j, w, h, r) &&
+                !(i > 0 && j > 0 && i < w - 1 && j < h - 1 && inRoundRect(i - 1, j, w, h, r) &&
+                  inRoundRect(i + 1, j, w, h, r) && inRoundRect(i, j - 1, w, h, r) &&
+                  inRoundRect(i, j + 1, w, h, r)))
+                drawPixel(x + i, y + j, color);
+}
+
+// ---- sprite ----
+
+void *TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t) {
+    deleteSprite();
+    _img = (uint16_t *)calloc((size_t)w * h, 2);
+    _width = w; _height = h;
+    resetViewport();
+    return _img;
+}
+
+void TFT_eSprite::deleteSprite() {
+    free(_img);
+    _img = nullptr;
+}
+
+void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    x += _xDatum; y += _yDatum;
+    if (!_img || x < _vpX || y < _vpY || x >= _vpW || y >= _vpH) return;
+    _img[x + y * _width] = (uint16_t)((color >> 8) | (color << 8));
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
+    x += _xDatum; y += _yDatum;
+    if (!_img || x < _vpX || y < _vpY || x >= _vpW || y >= _vpH) return 0xFFFF;
+    uint16_t c = _img[x + y * _width];
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    x += _xDatum; y += _yDatum;
+    int32_t x1 = std::min<int32_t>(x + w, _vpW), y1 = std::min<int32_t>(y + h, _vpH);
+    x = std::max<int32_t>(x, _vpX); y = std::max<int32_t>(y, _vpY);
+    if (!_img) return;
+    uint16_t c = (uint16_t)((color >> 8) | (color << 8));
+    for (int32_t j = y; j < y1; j++)
+        for (int32_t i = x; i < x1; i++) _img[i + j * _width] = c;
+}
+
+void TFT_eSprite::fillSprite(uint32_t color) {
+    int32_t xd = _xDatum, yd = _yDatum;
+    fillRect(_vpX - xd, _vpY - yd, _vpW - _vpX, _vpH - _vpY, color);
+}
+
+void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data) {
+    if (!_img || !data) return;
+    x += _xDatum; y += _yDatum;
+    for (int32_t j = 0; j < h; j++) {
+        int32_t yy = y + j;
+        if (yy < _vpY || yy >= _vpH) continue;
+        for (int32_t i = 0; i < w; i++) {
+            int32_t xx = x + i;
+            if (xx < _vpX || xx >= _vpW) continue;
+            _img[xx + yy * _width] = data[i + j * w];
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include <Wire.h>
+
+// Return codes as the ESP32 core gives them
+static const uint8_t WIRE_OK = 0, WIRE_NACK_ADDR = 2, WIRE_NACK_DATA = 3, WIRE_TIMEOUT = 5;
+
+void TwoWire::seed(uint32_t s) {
+    rng = s ? s : 1;
+}
+
+// xorshift32, so a run with the same seed injects the same faults
+bool TwoWire::roll(double p) {
+    if (p <= 0) return false;
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng < p * 4294967296.0;
+}
+
+void TwoWire::flipBit(uint8_t *buf, size_t len) {
+    if (!len) return;
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    buf[(rng >> 3) % len] ^= 1 << (rng & 7);
+    stats.corrupted++;
+}
+
+// Start, address and data bytes, 9 clocks each
+void TwoWire::busTime(size_t bytes) {
+    stats.bytes += bytes;
+    delayMicroseconds((unsigned int)((bytes + 1) * 9 * 1000000ull / clockHz));
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    stats.transactions++;
+    SimI2cDevice *device = devices[txAddress & 0x7F];
+    if (!device) { busTime(0); return WIRE_NACK_ADDR; }
+    if (roll(faults.timeout)) { stats.timeouts++; delay(timeoutMs); return WIRE_TIMEOUT; }
+    busTime(txLen);
+    if (roll(faults.nack)) { stats.nacks++; return WIRE_NACK_DATA; }
+    if (roll(faults.corrupt)) flipBit(txBuf, txLen);
+    return device->receive(txBuf, txLen) ? WIRE_OK : WIRE_NACK_DATA;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t len, bool sendStop) {
+    stats.transactions++;
+    rxLen = rxPos = 0;
+    SimI2cDevice *device = devices[address & 0x7F];
+    if (!device) { busTime(0); return 0; }
+    if (roll(faults.timeout)) { stats.timeouts++; delay(timeoutMs); return 0; }
+    if (roll(faults.nack)) { stats.nacks++; busTime(0); return 0; }
+    rxLen = device->request(rxBuf, std::min(len, sizeof(rxBuf)));
+    busTime(rxLen);
+    if (roll(faults.corrupt)) flipBit(rxBuf, rxLen);
+    return (uint8_t)rxLen;
+}
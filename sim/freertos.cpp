@@ -0,0 +1,92 @@
+#include <Arduino.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SimTask {
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+};
+
+static thread_local SimTask *currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *, uint32_t, void *arg,
+                                   UBaseType_t, TaskHandle_t *handle, BaseType_t) {
+    SimTask *t = new SimTask();
+    if (handle) *handle = t;
+    std::thread([fn, arg, t] { currentTask = t; fn(arg); }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t) {
+    std::lock_guard<std::mutex> lock(t->m);
+    t->notify++;
+    t->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t t, BaseType_t *woken) {
+    xTaskNotifyGive(t);
+    if (woken) *woken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    SimTask *t = currentTask;
+    std::unique_lock<std::mutex> lock(t->m);
+    auto ready = [t] { return t->notify > 0; };
+    if (ticks == portMAX_DELAY) t->cv.wait(lock, ready);
+    else t->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    uint32_t n = t->notify;
+    if (n) t->notify = clearOnExit ? 0 : n - 1;
+    return n;
+}
+
+void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+struct SimQueue {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length, itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue *q = new SimQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(q->m);
+    auto space = [q] { return q->items.size() < q->length; };
+    if (ticks == portMAX_DELAY) q->cv.wait(lock, space);
+    else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), space)) return pdFALSE;
+    const uint8_t *p = (const uint8_t *)item;
+    q->items.emplace_back(p, p + q->itemSize);
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(q->m);
+    auto ready = [q] { return !q->items.empty(); };
+    if (ticks == portMAX_DELAY) q->cv.wait(lock, ready);
+    else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->m);
+    return (UBaseType_t)q->items.size();
+}
@@ -0,0 +1,84 @@
+// Host-side stand-in for the Arduino core: just enough of the API that
+// src/main.cpp uses, backed by the C++ standard library.
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <pgmspace.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+using std::abs;
+using std::min;
+using std::max;
+using std::isnan;
+
+class String {
+public:
+    String() {}
+    String(const char *s) : s_(s ? s : "") {}
+    String(char c) : s_(1, c) {}
+    String(const std::string &s) : s_(s) {}
+    unsigned int length() const { return (unsigned int)s_.size(); }
+    const char *c_str() const { return s_.c_str(); }
+    char operator[](unsigned int i) const { return s_[i]; }
+    String &operator+=(char c) { s_ += c; return *this; }
+    String &operator+=(const char *s) { s_ += s; return *this; }
+    String &operator+=(const String &s) { s_ += s.s_; return *this; }
+    bool operator==(const String &o) const { return s_ == o.s_; }
+    bool operator==(const char *o) const { return s_ == o; }
+    bool operator!=(const String &o) const { return s_ != o.s_; }
+    bool operator!=(const char *o) const { return s_ != o; }
+private:
+    std::string s_;
+};
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    template <typename... A> int printf(const char *fmt, A... a) { return std::printf(fmt, a...); }
+    void print(const char *s) { std::fputs(s, stdout); }
+    void println(const char *s = "") { std::puts(s); }
+};
+extern HardwareSerial Serial;
+
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define OUTPUT 0x03
+#define FALLING 0x02
+#define RISING 0x01
+#define LOW 0
+#define HIGH 1
+#define IRAM_ATTR
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+    bool begin(size_t size) { if (size > sizeof(bytes)) return false; return true; }
+    template <typename T> T &get(int addr, T &t) { memcpy(&t, bytes + addr, sizeof(T)); return t; }
+    template <typename T> const T &put(int addr, const T &t) { memcpy(bytes + addr, &t, sizeof(T)); return t; }
+    bool commit() { return true; }
+    uint8_t bytes[512] = {};
+};
+extern EEPROMClass EEPROM;
+
+#endif
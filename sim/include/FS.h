@@ -0,0 +1,100 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs {
+
+// A file of the in-memory filesystem below; writes land at once.
+class File {
+public:
+    File() {}
+    File(std::shared_ptr<std::vector<uint8_t>> bytes, bool append) : bytes(bytes) {
+        if (append) pos = bytes->size();
+    }
+    explicit operator bool() const { return (bool)bytes; }
+    size_t write(const uint8_t *buf, size_t n) {
+        if (!bytes) return 0;
+        if (bytes->size() < pos + n) bytes->resize(pos + n);
+        memcpy(bytes->data() + pos, buf, n);
+        pos += n;
+        return n;
+    }
+    size_t read(uint8_t *buf, size_t n) {
+        if (!bytes || pos >= bytes->size()) return 0;
+        n = std::min(n, bytes->size() - pos);
+        memcpy(buf, bytes->data() + pos, n);
+        pos += n;
+        return n;
+    }
+    bool seek(uint32_t p) { if (!bytes || p > bytes->size()) return false; pos = p; return true; }
+    size_t position() const { return pos; }
+    size_t size() const { return bytes ? bytes->size() : 0; }
+    void flush() {}
+    void close() { bytes.reset(); }
+
+private:
+    std::shared_ptr<std::vector<uint8_t>> bytes;
+    size_t pos = 0;
+};
+
+class FS {
+public:
+    File open(const char *path, const char *mode = "r") {
+        auto it = files.find(path);
+        if (mode[0] == 'r') {
+            if (it == files.end()) return File();
+            return File(it->second, false);
+        }
+        if (it == files.end() || mode[0] == 'w') {
+            files[path] = std::make_shared<std::vector<uint8_t>>();
+            it = files.find(path);
+        }
+        return File(it->second, mode[0] == 'a');
+    }
+    bool exists(const char *path) { return files.count(path) || dirs.count(path); }
+    bool remove(const char *path) { return files.erase(path) > 0; }
+    bool rename(const char *from, const char *to) {
+        auto it = files.find(from);
+        if (it == files.end()) return false;
+        files[to] = it->second;
+        files.erase(from);
+        return true;
+    }
+    bool mkdir(const char *path) { dirs[path] = true; return true; }
+    size_t totalBytes() const { return capacity; }
+    size_t usedBytes() const {
+        size_t used = 0;
+        for (auto &f : files) used += (f.second->size() + blockSize - 1) / blockSize * blockSize + blockSize;
+        return used;
+    }
+
+    // Copies of every file, to put back with restore(): what the flash
+    // held at some moment, e.g. a power cut
+    std::map<std::string, std::vector<uint8_t>> snapshot() const {
+        std::map<std::string, std::vector<uint8_t>> copy;
+        for (auto &f : files) copy[f.first] = *f.second;
+        return copy;
+    }
+    void restore(const std::map<std::string, std::vector<uint8_t>> &copy) {
+        files.clear();
+        for (auto &f : copy) files[f.first] = std::make_shared<std::vector<uint8_t>>(f.second);
+    }
+
+    size_t capacity = 1408 * 1024;      // the spiffs partition of the default table
+    static const size_t blockSize = 4096;
+
+protected:
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+    std::map<std::string, bool> dirs;
+};
+
+} // namespace fs
+
+using fs::File;
+
+#endif
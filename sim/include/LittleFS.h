@@ -0,0 +1,14 @@
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include <FS.h>
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false) { mounted = true; return true; }
+    void end() { mounted = false; }
+    bool mounted = false;
+};
+extern LittleFSFS LittleFS;
+
+#endif
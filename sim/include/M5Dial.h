@@ -0,0 +1,41 @@
+// Host-side stand-in for the M5Dial board library. The encoder position
+// and button presses are driven by the simulator script in sim/.
+#ifndef SIM_M5DIAL_H
+#define SIM_M5DIAL_H
+
+#include <M5Unified.h>
+
+class SimEncoder {
+public:
+    long read() { return position; }
+    long position = 0;
+};
+
+class SimButton {
+public:
+    bool wasPressed() { return pressed; }
+    bool pressed = false;
+    bool pending = false;
+};
+
+class SimSpeaker {
+public:
+    void setVolume(uint8_t) {}
+    void tone(float, uint32_t) {}
+};
+
+class M5DialBoard {
+public:
+    void begin(m5::config_t, bool enableEncoder = false, bool enableRFID = false) {}
+    void update() {
+        BtnA.pressed = BtnA.pending;
+        BtnA.pending = false;
+    }
+    M5GFX Display;
+    SimEncoder Encoder;
+    SimButton BtnA;
+    SimSpeaker Speaker;
+};
+extern M5DialBoard M5Dial;
+
+#endif
@@ -0,0 +1,31 @@
+// Host-side stand-in for M5GFX: the Dial's 240x240 panel as an in-memory
+// RGB565 framebuffer. Pixels pushed from TFT_eSprite buffers arrive
+// byte-swapped, as LovyanGFX expects for uint16_t* images.
+#ifndef SIM_M5GFX_H
+#define SIM_M5GFX_H
+
+#include <Arduino.h>
+
+class M5GFX {
+public:
+    static const int WIDTH = 240;
+    static const int HEIGHT = 240;
+
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data) {
+        pushImage(x, y, w, h, data);
+    }
+    void startWrite() {}
+    void endWrite() {}
+    void waitDMA() {}
+    bool dmaBusy() { return false; }
+    int32_t width() const { return WIDTH; }
+    int32_t height() const { return HEIGHT; }
+
+    // Simulator hooks
+    uint16_t framebuffer[WIDTH * HEIGHT] = {};  // native-endian RGB565
+    unsigned long pushCount = 0;
+    unsigned long pixelsPushed = 0;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef SIM_M5UNIFIED_H
+#define SIM_M5UNIFIED_H
+
+#include <M5GFX.h>
+
+namespace m5 {
+struct config_t {};
+}
+
+class M5UnifiedStub {
+public:
+    m5::config_t config() { return m5::config_t(); }
+};
+extern M5UnifiedStub M5;
+
+#endif
@@ -0,0 +1,133 @@
+// Host-side stand-in for bodmer/TFT_eSPI: an in-memory RGB565 sprite with
+// the drawing primitives and VLW smooth-font renderer that src/main.cpp uses.
+// Pixels are stored byte-swapped, as the real TFT_eSprite does.
+#ifndef SIM_TFT_ESPI_H
+#define SIM_TFT_ESPI_H
+
+#include <Arduino.h>
+
+#define TFT_BLACK   0x0000
+#define TFT_NAVY    0x000F
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE    0x001F
+#define TFT_GREEN   0x07E0
+#define TFT_DARKGREEN 0x03E0
+#define TFT_CYAN    0x07FF
+#define TFT_RED     0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW  0xFFE0
+#define TFT_WHITE   0xFFFF
+#define TFT_ORANGE  0xFDA0
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t w = 240, int16_t h = 240) : _width(w), _height(h) {}
+    virtual ~TFT_eSPI() {}
+
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+    uint16_t alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc);
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    // Smooth (VLW) fonts
+    void loadFont(const uint8_t array[]);
+    void unloadFont();
+    int16_t textWidth(const char *string);
+    int16_t textWidth(const String &s) { return textWidth(s.c_str()); }
+    int16_t fontHeight();
+
+    void setTextDatum(uint8_t d) { textdatum = d; }
+    uint8_t getTextDatum() { return textdatum; }
+    void setTextColor(uint16_t fg) { textcolor = fg; textbgcolor = fg; _fillbg = false; }
+    void setTextColor(uint16_t fg, uint16_t bg, bool bgfill = false) {
+        textcolor = fg; textbgcolor = bg; _fillbg = bgfill;
+    }
+    void setTextSize(uint8_t s) { textsize = s; }
+    int16_t drawString(const char *string, int32_t x, int32_t y);
+    int16_t drawString(const String &s, int32_t x, int32_t y) { return drawString(s.c_str(), x, y); }
+
+    // Viewport
+    void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+    void resetViewport() { setViewport(0, 0, _width, _height, false); }
+
+    virtual void drawPixel(int32_t x, int32_t y, uint32_t color) {}
+    virtual uint16_t readPixel(int32_t x, int32_t y) { return 0; }
+    virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+    void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+
+    typedef struct {
+        const uint8_t *gArray;
+        uint16_t gCount;
+        uint16_t yAdvance;
+        uint16_t spaceWidth;
+        int16_t ascent;
+        int16_t descent;
+        uint16_t maxAscent;
+        uint16_t maxDescent;
+    } fontMetrics;
+
+    fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
+    uint16_t *gUnicode = NULL;
+    uint8_t *gHeight = NULL;
+    uint8_t *gWidth = NULL;
+    uint8_t *gxAdvance = NULL;
+    int16_t *gdY = NULL;
+    int8_t *gdX = NULL;
+    uint32_t *gBitmap = NULL;
+    bool fontLoaded = false;
+
+    bool getUnicodeIndex(uint16_t unicode, uint16_t *index);
+    void drawGlyph(uint16_t code);
+
+protected:
+    int32_t _width, _height;
+    int32_t _vpX = 0, _vpY = 0, _vpW = 0, _vpH = 0;
+    int32_t _xDatum = 0, _yDatum = 0;
+    bool _vpDatum = false;
+    int32_t cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF, textbgcolor = 0;
+    bool _fillbg = false;
+    uint8_t textdatum = TL_DATUM, textsize = 1;
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI *tft) : TFT_eSPI(0, 0) {}
+    ~TFT_eSprite() { deleteSprite(); }
+
+    void *createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+    void deleteSprite();
+    bool created() const { return _img != nullptr; }
+    void *getPointer() { return _img; }
+    void fillSprite(uint32_t color);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data);
+
+    void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+    uint16_t readPixel(int32_t x, int32_t y) override;
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override;
+
+private:
+    uint16_t *_img = nullptr;
+};
+
+#endif
@@ -0,0 +1,75 @@
+// Host-side stand-in for the Arduino TwoWire master. Transactions go to
+// whatever SimI2cDevice is attached at the address; with nothing attached
+// they NACK, which the firmware reports as "NO CONNECT". Each transfer
+// advances virtual time by its length on the wire at the set clock, and
+// faults can be injected per transaction, see SimBusFaults.
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+// A simulated target. receive() gets the bytes of a write transaction
+// (returning false NACKs them); request() fills the reply to a read and
+// returns how many bytes it has.
+class SimI2cDevice {
+public:
+    virtual ~SimI2cDevice() {}
+    virtual bool receive(const uint8_t *data, size_t len) = 0;
+    virtual size_t request(uint8_t *buf, size_t len) = 0;
+};
+
+// Probability per transaction of each fault.
+struct SimBusFaults {
+    double nack = 0;        // the target NACKs the data
+    double corrupt = 0;     // one bit flipped on the wire
+    double timeout = 0;     // the target stretches the clock past the Wire timeout
+};
+
+struct SimBusStats {
+    unsigned long transactions = 0, bytes = 0;
+    unsigned long nacks = 0, corrupted = 0, timeouts = 0;
+};
+
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    void setClock(uint32_t hz) { clockHz = hz; }
+    void setTimeOut(uint16_t ms) { timeoutMs = ms; }
+    void beginTransmission(uint8_t address) { txAddress = address; txLen = 0; }
+    size_t write(uint8_t b) { if (txLen < sizeof(txBuf)) txBuf[txLen++] = b; return 1; }
+    size_t write(const uint8_t *data, size_t n) { for (size_t i = 0; i < n; i++) write(data[i]); return n; }
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, size_t len, bool sendStop = true);
+    int available() { return (int)(rxLen - rxPos); }
+    int read() { return rxPos < rxLen ? rxBuf[rxPos++] : -1; }
+    size_t readBytes(uint8_t *buf, size_t n) {
+        size_t i = 0;
+        while (i < n && rxPos < rxLen) buf[i++] = rxBuf[rxPos++];
+        return i;
+    }
+
+    // --- simulator side ---
+    void attach(uint8_t address, SimI2cDevice *device) { devices[address & 0x7F] = device; }
+    void seed(uint32_t s);
+
+    SimBusFaults faults;
+    SimBusStats stats;
+    uint32_t clockHz = 100000;
+    uint16_t timeoutMs = 50;
+    uint8_t txAddress = 0;
+    uint8_t txBuf[256];
+    size_t txLen = 0;
+    uint8_t rxBuf[256];
+    size_t rxLen = 0, rxPos = 0;
+
+private:
+    bool roll(double p);
+    void flipBit(uint8_t *buf, size_t len);
+    void busTime(size_t bytes);
+
+    SimI2cDevice *devices[128] = {};
+    uint32_t rng = 1;
+};
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,20 @@
+// Host-side stand-in for the FreeRTOS pieces the firmware uses. Tasks are
+// std::threads; one tick is one millisecond.
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portTICK_PERIOD_MS 1
+
+#endif
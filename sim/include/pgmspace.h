@@ -0,0 +1,4 @@
+#ifndef SIM_PGMSPACE_H
+#define SIM_PGMSPACE_H
+#define PROGMEM
+#endif
@@ -0,0 +1,490 @@
+// Headless runner: drives setup()/loop() from src/main.cpp with a scripted
+// encoder/button sequence against simulated mainboards (ControllerSim),
+// dumps each visited screen as a PNG and writes the render time of every
+// frame to frames.csv. Afterwards it measures telemetry and command
+// latency over the I2C path, runs a test to the on-flash test log (and
+// cuts the power in a second one), checks the log codec on a day of
+// samples and prints bus statistics. Exits with 1 if any of those checks
+// fail (lost or slow transfers, test log contents, codec round trip).
+//
+//   pio run -e native && .pio/build/native/program [output dir] [options]
+//     --zones N          mainboards at I2C_ADDR_MAINBOARD + 0..N-1 (default 1)
+//     --no-controller    nothing on the bus
+//     --nack P, --corrupt P, --timeout P
+//                        per transaction fault probabilities
+//     --seed N           fault pattern
+#include <Arduino.h>
+#include <M5Dial.h>
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include <Wire.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "ControllerSim.h"
+#include "../src/TestLog.h"
+#include "../src/TieredLog.h"
+
+void setup();
+void loop();
+
+// Frame counters kept by the scheduler in src/main.cpp
+extern unsigned long framesRendered;
+extern unsigned long lastFrameMicros;
+// Controller side of src/main.cpp
+extern ControllerData data;
+extern std::atomic<uint32_t> i2cBadFrames;
+extern TieredLog<200> *logData[];    // ZoneLog; a size that differs fails to link
+void sendCommand(CommandType type, float a, float b, float c);
+void beginTestLog();
+uint16_t testPageCrc(const LogPage &page);
+
+HardwareSerial Serial;
+M5UnifiedStub M5;
+M5DialBoard M5Dial;
+EEPROMClass EEPROM;
+LittleFSFS LittleFS;
+TwoWire Wire;
+
+static const auto simStart = std::chrono::steady_clock::now();
+static unsigned long simSkewUs = 0;
+
+unsigned long micros() {
+    auto dt = std::chrono::steady_clock::now() - simStart;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(dt).count() + simSkewUs;
+}
+unsigned long millis() { return micros() / 1000; }
+void delay(unsigned long ms) { simSkewUs += ms * 1000; }  // virtual time, no sleeping
+void delayMicroseconds(unsigned int us) { simSkewUs += us; }
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void attachInterrupt(uint8_t, void (*)(), int) {}
+
+void M5GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data) {
+    pushCount++;
+    for (int32_t j = 0; j < h; j++) {
+        for (int32_t i = 0; i < w; i++) {
+            int32_t xx = x + i, yy = y + j;
+            if (xx < 0 || yy < 0 || xx >= WIDTH || yy >= HEIGHT) continue;
+            uint16_t c = data[i + j * w];
+            framebuffer[xx + yy * WIDTH] = (uint16_t)((c >> 8) | (c << 8));
+            pixelsPushed++;
+        }
+    }
+}
+
+// ---- minimal PNG writer (stored deflate blocks) ----
+
+static uint32_t crcTable[256];
+
+static uint32_t crc32(uint32_t crc, const uint8_t *p, size_t n) {
+    if (!crcTable[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            crcTable[i] = c;
+        }
+    }
+    crc = ~crc;
+    while (n--) crc = crcTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put32(std::vector<uint8_t> &v, uint32_t x) {
+    v.push_back(x >> 24); v.push_back(x >> 16); v.push_back(x >> 8); v.push_back(x);
+}
+
+static void chunk(FILE *f, const char *type, const std::vector<uint8_t> &body) {
+    std::vector<uint8_t> v;
+    put32(v, (uint32_t)body.size());
+    v.insert(v.end(), type, type + 4);
+    v.insert(v.end(), body.begin(), body.end());
+    put32(v, crc32(0, v.data() + 4, v.size() - 4));
+    fwrite(v.data(), 1, v.size(), f);
+}
+
+static void dumpPng(const char *path) {
+    const int W = M5GFX::WIDTH, H = M5GFX::HEIGHT;
+    std::vector<uint8_t> raw;
+    for (int y = 0; y < H; y++) {
+        raw.push_back(0);
+        for (int x = 0; x < W; x++) {
+            uint16_t c = M5Dial.Display.framebuffer[x + y * W];
+            raw.push_back(((c >> 11) & 0x1F) * 255 / 31);
+            raw.push_back(((c >> 5) & 0x3F) * 255 / 63);
+            raw.push_back((c & 0x1F) * 255 / 31);
+        }
+    }
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (uint8_t c : raw) { a = (a + c) % 65521; b = (b + a) % 65521; }
+    for (size_t off = 0; off < raw.size(); off += 65535) {
+        size_t n = std::min<size_t>(65535, raw.size() - off);
+        z.push_back(off + n == raw.size());
+        z.push_back(n & 0xFF); z.push_back(n >> 8);
+        z.push_back(~n & 0xFF); z.push_back((~n >> 8) & 0xFF);
+        z.insert(z.end(), raw.begin() + off, raw.begin() + off + n);
+    }
+    put32(z, (b << 16) | a);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) { perror(path); return; }
+    static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(sig, 1, 8, f);
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, W); put32(ihdr, H);
+    ihdr.push_back(8); ihdr.push_back(2); ihdr.push_back(0); ihdr.push_back(0); ihdr.push_back(0);
+    chunk(f, "IHDR", ihdr);
+    chunk(f, "IDAT", z);
+    chunk(f, "IEND", {});
+    fclose(f);
+}
+
+// ---- script ----
+
+struct Timing {
+    unsigned long loops = 0, totalUs = 0, maxUs = 0;
+    unsigned long frames = 0, frameTotalUs = 0, frameMaxUs = 0;
+};
+static Timing stepTiming;
+static unsigned long stepPixels = 0, stepPushes = 0;
+static const char *outDir = ".";
+static FILE *frameLog = nullptr;
+
+// Frames rendered since the last step; logged under that step's name.
+struct FrameRecord { unsigned long frame, renderUs, pixels; };
+static std::vector<FrameRecord> stepFrames;
+
+static void runLoops(int n) {
+    for (int i = 0; i < n; i++) {
+        unsigned long frames0 = framesRendered, pixels0 = M5Dial.Display.pixelsPushed;
+        unsigned long t0 = micros(), skew0 = simSkewUs;
+        loop();
+        unsigned long dt = micros() - t0 - (simSkewUs - skew0);
+        stepTiming.loops++;
+        stepTiming.totalUs += dt;
+        if (dt > stepTiming.maxUs) stepTiming.maxUs = dt;
+
+        if (framesRendered != frames0) {
+            stepTiming.frames++;
+            stepTiming.frameTotalUs += lastFrameMicros;
+            if (lastFrameMicros > stepTiming.frameMaxUs) stepTiming.frameMaxUs = lastFrameMicros;
+            stepFrames.push_back({ framesRendered, lastFrameMicros, M5Dial.Display.pixelsPushed - pixels0 });
+        }
+    }
+}
+
+// Runs a few more loop passes, dumps the panel and reports timing for
+// everything since the previous step.
+static void step(const char *name, int loops) {
+    runLoops(loops);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/sim_%s.png", outDir, name);
+    dumpPng(path);
+    const Timing &t = stepTiming;
+    printf("%-20s loops=%-5lu avg=%7.1fus max=%6luus frames=%-3lu frame avg=%7.1fus max=%6luus pushes=%-5lu px=%lu\n",
+           name, t.loops, t.loops ? (double)t.totalUs / t.loops : 0.0, t.maxUs,
+           t.frames, t.frames ? (double)t.frameTotalUs / t.frames : 0.0, t.frameMaxUs,
+           M5Dial.Display.pushCount - stepPushes, M5Dial.Display.pixelsPushed - stepPixels);
+    if (frameLog) {
+        for (const FrameRecord &f : stepFrames) fprintf(frameLog, "%s,%lu,%lu,%lu\n", name, f.frame, f.renderUs, f.pixels);
+    }
+    stepFrames.clear();
+    stepTiming = Timing();
+    stepPushes = M5Dial.Display.pushCount;
+    stepPixels = M5Dial.Display.pixelsPushed;
+}
+
+static void press() {
+    M5Dial.BtnA.pending = true;
+    runLoops(10);
+}
+
+static void turn(int detents) {
+    for (int i = 0; i < abs(detents); i++) {
+        M5Dial.Encoder.position += detents > 0 ? 4 : -4;
+        runLoops(10);
+    }
+}
+
+// ---- I2C latency ----
+
+static std::vector<std::unique_ptr<ControllerSim>> controllers;
+
+// Runs loop() until done() or timeoutMs of virtual time pass. Returns the
+// virtual ms it took, or -1 on timeout.
+template <typename Done>
+static long runUntil(Done done, unsigned long timeoutMs) {
+    unsigned long t0 = millis();
+    while (!done()) {
+        if (millis() - t0 > timeoutMs) return -1;
+        runLoops(1);
+    }
+    return (long)(millis() - t0);
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (ok) return;
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+struct Latency {
+    int n = 0, lost = 0;
+    long total = 0, max = 0;
+    void add(long ms) {
+        if (ms < 0) { lost++; return; }
+        n++; total += ms;
+        if (ms > max) max = ms;
+    }
+    void print(const char *name) const {
+        printf("%-20s n=%-3d avg=%7.1fms max=%5ldms lost=%d\n", name, n, n ? (double)total / n : 0.0, max, lost);
+    }
+};
+
+// Changes a field on the mainboard and waits for the dial to show it, then
+// sends a command from the dial and waits for the mainboard to apply it.
+static void measureLatency(int rounds) {
+    ControllerSim &c = *controllers[0];
+    Latency telemetry, command;
+    for (int r = 0; r < rounds; r++) {
+        uint8_t error = (r % 2 == 0) ? 1 : 0;
+        c.state.errorState = error;
+        c.update();
+        telemetry.add(runUntil([&] { return data.errorState == error; }, 5000));
+
+        float setpoint = 60.0f + r;
+        sendCommand(CMD_SET_SETPOINT, setpoint, 0, 0);
+        command.add(runUntil([&] { return c.state.setpoint == setpoint; }, 5000));
+    }
+    telemetry.print("telemetry latency");
+    command.print("command latency");
+    // A change must show within the slowest poll (the disconnected backoff)
+    // plus a retry; a command within its resends
+    check(telemetry.lost == 0 && telemetry.max <= 2500, "telemetry latency");
+    check(command.lost == 0 && command.max <= 1000, "command latency");
+}
+
+// ---- test log ----
+
+static void runFor(unsigned long ms) {
+    unsigned long t0 = millis();
+    while (millis() - t0 < ms) runLoops(1);
+}
+
+struct RunSummary {
+    LogRunEntry entry;
+    unsigned long valid, records, bytes;    // pages that check out, their records
+};
+
+// Checks every run in the index against its file, page by page.
+static std::vector<RunSummary> readTestLog() {
+    std::vector<RunSummary> runs;
+    File index = LittleFS.open(TEST_LOG_INDEX, "r");
+    LogRunEntry e;
+    while (index && index.read((uint8_t *)&e, sizeof(e)) == sizeof(e)) {
+        char path[24];
+        snprintf(path, sizeof(path), TEST_LOG_DIR "/%05u", e.run);
+        File f = LittleFS.open(path, "r");
+        RunSummary run = { e, 0, 0, (unsigned long)f.size() };
+        LogPage page;
+        LogRecord r;
+        while (f && f.read((uint8_t *)&page, sizeof(page)) == sizeof(page)) {
+            if (page.header.magic != TEST_LOG_MAGIC || page.header.crc != testPageCrc(page)) break;
+            run.valid++;
+            LogDecoder decoder(page);
+            while (decoder.next(r)) run.records++;
+        }
+        printf("test log run %-5u zone %u %s pages=%lu (index %lu) records=%lu bytes=%lu\n", e.run, e.zone,
+               (e.flags & LOG_RUN_CLOSED) ? "closed" : "open  ", run.valid, (unsigned long)e.pages, run.records,
+               run.bytes);
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+// Encodes a synthetic day at 1 Hz (a ramp to setpoint with sensor noise
+// and a setpoint change), decodes it again and reports size and speed.
+static void benchmarkLogCodec() {
+    const uint32_t seconds = 24 * 3600;
+    std::vector<LogPage> pages(1);
+    LogEncoder encoder;
+    memset(&pages[0], 0, sizeof(LogPage));
+    uint32_t noise = 2463534242u;
+    float temp = 25;
+    std::vector<LogRecord> records(seconds);
+    for (uint32_t t = 0; t < seconds; t++) {
+        noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+        float setpoint = t < seconds / 2 ? 180 : 120;
+        float output = constrain((setpoint - temp) * 4, 0.0f, 100.0f);
+        temp += (output * 0.02f - (temp - 25) / 200.0f);
+        LogRecord &r = records[t];
+        r.seconds = t;
+        r.temp = (int16_t)lroundf(temp * 10) + (int)(noise % 3) - 1;
+        r.setpoint = (int16_t)lroundf(setpoint * 10);
+        r.output = (int16_t)lroundf(output * 10);
+        r.errorState = 0;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    // Pages cut by age as well, as serviceTestLog() writes them
+    uint32_t pageStart = 0;
+    for (const LogRecord &r : records) {
+        if (r.seconds - pageStart >= TEST_LOG_PAGE_MAX_SECONDS || !encoder.append(pages.back(), r)) {
+            pages.emplace_back();
+            memset(&pages.back(), 0, sizeof(LogPage));
+            encoder.reset();
+            encoder.append(pages.back(), r);
+            pageStart = r.seconds;
+        }
+    }
+    double encodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / seconds;
+    size_t matched = 0;
+    bool same = true;
+    for (const LogPage &page : pages) {
+        LogDecoder decoder(page);
+        LogRecord r;
+        while (same && matched < seconds && decoder.next(r)) {
+            const LogRecord &e = records[matched];
+            same = r.seconds == e.seconds && r.temp == e.temp && r.setpoint == e.setpoint &&
+                   r.output == e.output && r.errorState == e.errorState;
+            if (same) matched++;
+        }
+    }
+    size_t bytes = pages.size() * sizeof(LogPage);
+    printf("log codec            %lu s in %lu pages, %lu bytes (%.2f B/s, %.1fx vs 16 B/s), encode %.0f ns/s\n",
+           (unsigned long)seconds, (unsigned long)pages.size(), (unsigned long)bytes, (double)bytes / seconds,
+           16.0 * seconds / bytes, encodeNs);
+    check(matched == seconds, "log codec decodes what it encoded");
+    check(16.0 * seconds / bytes >= 5, "log codec at least 5x smaller than floats");
+}
+
+// A whole test, then one that a power cut interrupts: the flash as it was
+// at the cut (plus half a page the cut tore) is put back once the dial has
+// closed the run, the filesystem re-mounted and the index recovered.
+static void exerciseTestLog() {
+    const unsigned long firstMs = 70000, secondMs = 280000;    // under the tour's 5 min auto stop
+    ControllerSim &c = *controllers[0];
+    // Sends a command until the mainboard has it, then waits for the dial
+    // to see the result; faults may eat a command's every attempt
+    auto setRunning = [&](bool running) {
+        for (int i = 0; i < 5 && (bool)c.state.isRunning != running; i++) {
+            sendCommand(running ? CMD_START_TEST : CMD_STOP_TEST, 0, 0, 0);
+            runUntil([&] { return (bool)c.state.isRunning == running; }, 1000);
+        }
+        runUntil([&] { return (bool)data.isRunning == running; }, 5000);
+    };
+    setRunning(true);
+    runFor(firstMs);
+    setRunning(false);
+    runFor(3000);
+    setRunning(true);
+    runFor(secondMs);
+    auto flash = LittleFS.snapshot();
+    setRunning(false);
+    runFor(3000);
+
+    std::vector<RunSummary> before = readTestLog();
+    LittleFS.end();
+    if (before.size() == 2) {
+        char path[24];
+        snprintf(path, sizeof(path), TEST_LOG_DIR "/%05u", before[1].entry.run);
+        flash[path].resize(flash[path].size() + TEST_LOG_PAGE_SIZE / 2, 0xA5);
+    }
+    LittleFS.restore(flash);
+    beginTestLog();
+    std::vector<RunSummary> after = readTestLog();
+
+    check(before.size() == 2 && after.size() == 2, "test log has both runs");
+    if (before.size() != 2 || after.size() != 2) return;
+    for (const RunSummary &run : after) {
+        check(run.entry.flags & LOG_RUN_CLOSED, "test log runs closed after recovery");
+        check(run.valid == run.entry.pages, "test log index matches the pages that check out");
+    }
+    // Also under injected faults: a flaky transfer must not drop the link
+    unsigned long firstS = firstMs / 1000, secondS = secondMs / 1000;
+    check(before[0].records + 2 >= firstS && before[0].records <= firstS + 2, "test log has a record a second");
+    check(before[1].records + 2 >= secondS, "test log keeps a run that ends normally whole");
+    // The cut loses the page being filled, which is never more than
+    // TEST_LOG_PAGE_MAX_SECONDS old
+    check(after[1].records > 0 && after[1].records <= before[1].records &&
+          after[1].entry.pages + 1 >= before[1].entry.pages, "test log loses at most a page to a power cut");
+    check(after[1].records + TEST_LOG_PAGE_MAX_SECONDS + 2 >= before[1].records,
+          "test log loses at most two minutes to a power cut");
+}
+
+// The mainboard's test ran before the dial booted, and longer than tier 0
+// spans, so only a backfill of the coarser tiers can show its peak.
+static void checkBackfill() {
+    const auto *log = logData[0];
+    check(log && log->tier(1).means.size() >= 110 && log->tier(2).means.size() >= 18,
+          "history backfills the coarser tiers");
+    check(log && log->tier(1).highs.max() > 60, "backfilled tiers hold the test from before the dial booted");
+}
+
+static void printBusStats() {
+    const SimBusStats &b = Wire.stats;
+    double seconds = millis() / 1000.0;
+    printf("bus                  %lu transactions, %lu bytes, %.0f B/s at %lu kHz, nacks=%lu timeouts=%lu corrupted=%lu\n",
+           b.transactions, b.bytes, b.bytes / seconds, (unsigned long)Wire.clockHz / 1000, b.nacks, b.timeouts, b.corrupted);
+    unsigned long dropped = 0, applied = 0;
+    for (auto &c : controllers) { dropped += c->framesDropped; applied += c->commandsApplied; }
+    printf("frames               dial dropped %lu, controllers dropped %lu, commands applied %lu\n",
+           (unsigned long)i2cBadFrames.load(), dropped, applied);
+}
+
+int main(int argc, char **argv) {
+    int zones = 1;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : "0";
+        if (!strcmp(arg, "--zones")) { zones = atoi(val); i++; }
+        else if (!strcmp(arg, "--no-controller")) zones = 0;
+        else if (!strcmp(arg, "--nack")) { Wire.faults.nack = atof(val); i++; }
+        else if (!strcmp(arg, "--corrupt")) { Wire.faults.corrupt = atof(val); i++; }
+        else if (!strcmp(arg, "--timeout")) { Wire.faults.timeout = atof(val); i++; }
+        else if (!strcmp(arg, "--seed")) { Wire.seed(strtoul(val, nullptr, 0)); i++; }
+        else outDir = arg;
+    }
+    for (int z = 0; z < zones && z < MAINBOARD_ADDR_COUNT; z++) {
+        controllers.emplace_back(new ControllerSim());
+        Wire.attach(I2C_ADDR_MAINBOARD + z, controllers.back().get());
+    }
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/frames.csv", outDir);
+    frameLog = fopen(path, "w");
+    if (!frameLog) perror(path);
+    else fprintf(frameLog, "step,frame,render_us,pixels_pushed\n");
+
+    setup();
+    step("main", 400);
+    press(); step("user_menu", 20);
+    turn(1); step("user_menu_scrolled", 20);
+    press(); step("set_time", 20);
+    turn(5); step("set_time_edited", 20);
+    press(); turn(-1); step("user_menu_back", 20);
+    press(); step("set_temp", 20);
+    turn(4); step("set_temp_edited", 20);
+    press(); step("user_menu_saved", 20);
+    turn(2); press(); step("log_graph", 400);
+    press(); turn(2); press(); step("password", 20);
+    for (int i = 0; i < 5; i++) { press(); turn(1); }
+    step("password_entered", 20);
+    press(); step("service_menu", 20);
+    turn(1); press(); step("diagnostics", 400);
+    if (!controllers.empty()) {
+        checkBackfill();
+        measureLatency(20);
+        step("latency", 0);
+        exerciseTestLog();
+        benchmarkLogCodec();
+    }
+    printBusStats();
+    if (frameLog) fclose(frameLog);
+    if (failures) printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,42 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include <stdint.h>
+
+// Single-producer / single-consumer "latest value wins" mailbox (a triple
+// buffer). The producer fills draft() and publish()es it; the consumer calls
+// fetch() and reads current(). Neither side blocks or takes a lock, and the
+// slot the consumer is reading is never written by the producer.
+// draft() holds stale data after publish(), so fill every field each time.
+template <typename T>
+class Mailbox {
+public:
+    // --- producer side ---
+    T &draft() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // --- consumer side ---
+    // Takes the newest published value, if there is one since the last fetch.
+    bool fetch() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T &current() const { return slots[front]; }
+
+private:
+    static const uint8_t INDEX = 0x03;
+    static const uint8_t FRESH = 0x04;
+
+    T slots[3];
+    std::atomic<uint8_t> middle{1};
+    uint8_t front = 0;      // consumer owned
+    uint8_t back = 2;       // producer owned
+};
+
+#endif
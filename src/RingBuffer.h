@@ -0,0 +1,106 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+
+// What a RingBuffer keeps track of besides the values; each costs a queue
+// of N positions.
+enum RingTrack { RING_PLAIN = 0, RING_MIN = 1, RING_MAX = 2, RING_MIN_MAX = RING_MIN | RING_MAX };
+
+// Monotonic queue of up to C positions; C = 0 holds nothing.
+template <int C>
+struct RingQueue {
+    uint32_t items[C];
+    int head = 0, length = 0;
+
+    void clear() { head = length = 0; }
+    bool empty() const { return length == 0; }
+    uint32_t front() const { return items[head]; }
+    uint32_t back() const { return items[(head + length - 1) % C]; }
+    void popFront() { head = (head + 1) % C; length--; }
+    void popBack() { length--; }
+    void pushBack(uint32_t p) { items[(head + length++) % C] = p; }
+};
+
+template <>
+struct RingQueue<0> {
+    void clear() {}
+    bool empty() const { return true; }
+    uint32_t front() const { return 0; }
+    uint32_t back() const { return 0; }
+    void popFront() {}
+    void popBack() {}
+    void pushBack(uint32_t) {}
+};
+
+// Fixed-capacity ring holding the last N values pushed, and, as Track
+// asks, their minimum and maximum. For each it keeps a monotonic queue of
+// positions, increasing values for the minimum and decreasing for the
+// maximum, whose front is the extreme of what is held; push(), min() and
+// max() are therefore O(1) (push amortized), whatever N is.
+// Not thread safe.
+template <typename T, int N, int Track = RING_MIN_MAX>
+class RingBuffer {
+public:
+    void clear() {
+        pushed = 0;
+        held = 0;
+        lows.clear();
+        highs.clear();
+    }
+
+    void push(T v) {
+        if (held == N) {
+            // The oldest value leaves; if it was an extreme it is at a front
+            uint32_t oldest = pushed - N;
+            if ((Track & RING_MIN) && lows.front() == oldest) lows.popFront();
+            if ((Track & RING_MAX) && highs.front() == oldest) highs.popFront();
+        } else {
+            held++;
+        }
+        values[pushed % N] = v;
+        if (Track & RING_MIN) {
+            while (!lows.empty() && at(lows.back()) >= v) lows.popBack();
+            lows.pushBack(pushed);
+        }
+        if (Track & RING_MAX) {
+            while (!highs.empty() && at(highs.back()) <= v) highs.popBack();
+            highs.pushBack(pushed);
+        }
+        pushed++;
+    }
+
+    int size() const { return held; }
+    bool full() const { return held == N; }
+
+    // i = 0 is the oldest value held
+    T operator[](int i) const { return at(pushed - held + i); }
+
+    // Only valid while size() > 0
+    T min() const {
+        static_assert(Track & RING_MIN, "this RingBuffer does not track its minimum");
+        return at(lows.front());
+    }
+    T max() const {
+        static_assert(Track & RING_MAX, "this RingBuffer does not track its maximum");
+        return at(highs.front());
+    }
+
+    // Copies the values oldest first; dst needs room for size() of them.
+    void copyTo(T *dst) const {
+        for (int i = 0; i < held; i++) dst[i] = (*this)[i];
+    }
+
+private:
+    // Positions are counted from the first push; position p lives in
+    // values[p % N] for as long as it is held.
+    T at(uint32_t position) const { return values[position % N]; }
+
+    T values[N];
+    uint32_t pushed = 0;
+    int held = 0;
+    RingQueue<(Track & RING_MIN) ? N : 0> lows;
+    RingQueue<(Track & RING_MAX) ? N : 0> highs;
+};
+
+#endif
@@ -2,11 +2,17 @@
 #define SHARED_DATA_H
 
 #include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
 
+// Mainboards sit at I2C_ADDR_MAINBOARD + n, n from their address jumpers,
+// one per oven zone.
 #define I2C_ADDR_MAINBOARD 0x42
+#define MAINBOARD_ADDR_COUNT 8
 
-// force byte-alignment so main S3 and Dial don't misinterpret data positions
-#pragma pack(push, 1)
+// In-memory form only; the bytes on the bus are laid out by
+// controllerFields[] and go through encodeField()/decodeField(), so
+// neither board depends on the other's struct layout or alignment.
 struct ControllerData {
     float currentTemp;
     float setpoint;
@@ -19,6 +25,266 @@ struct ControllerData {
     uint8_t errorState;
     uint32_t testDuration;
 };
+
+// --- REGISTER MAP (protocol v3) ---
+// Registers are read and written through frames (see FRAMING below). Both
+// auto-increment, and REG_DATA + n is byte n of the ControllerData wire
+// format, so a run of neighbouring fields is one transfer.
+//
+// REG_CHANGED holds one bit per ControllerField that changed on the
+// mainboard since the register was last read; reading it clears it. The
+// dial reads everything once after (re)connecting and afterwards only the
+// fields flagged there.
+//
+// The mainboard may also drive an open-drain data-ready line (active low)
+// for as long as REG_CHANGED is non-zero; the dial reads on its falling
+// edge. See CONTROLLER_DRDY_PIN in main.cpp.
+//
+// Telemetry is read only. The dial changes controller state only through
+// commands written to REG_COMMAND, see below. REG_HISTORY_SELECT only picks
+// what REG_HISTORY returns, see HISTORY below.
+#define CONTROLLER_PROTOCOL_VERSION 3
+
+enum ControllerRegister : uint8_t {
+    REG_VERSION = 0x00,     // uint8_t, CONTROLLER_PROTOCOL_VERSION
+    REG_CHANGED = 0x01,     // uint16_t ControllerField bitmask, little endian
+    REG_ACK     = 0x03,     // CommandAck of the last command received
+    REG_COMMAND = 0x08,     // ControllerCommand, write only
+    REG_DATA    = 0x18,     // ControllerData, CONTROLLER_WIRE_SIZE bytes
+    REG_HISTORY_INFO   = 0x40,  // HistoryInfo
+    REG_HISTORY_SELECT = 0x48,  // uint32_t, first sample number REG_HISTORY returns
+    REG_HISTORY        = 0x50,  // HistoryPage, read only
+};
+
+enum ControllerField : uint8_t {
+    CF_CURRENT_TEMP, CF_SETPOINT, CF_OUTPUT, CF_KP, CF_KI, CF_KD,
+    CF_IS_RUNNING, CF_IS_LOGGING, CF_ERROR_STATE, CF_TEST_DURATION,
+    CF_COUNT
+};
+
+// --- WIRE FORMAT ---
+// The ControllerData fields in ControllerField order, little endian and
+// without padding. The static_asserts below keep the table, the struct and
+// CONTROLLER_WIRE_SIZE in step.
+#define CONTROLLER_WIRE_SIZE 31
+
+struct ControllerFieldInfo {
+    uint8_t offset;         // in the wire format, i.e. register REG_DATA + offset
+    uint8_t size;
+};
+
+static constexpr ControllerFieldInfo controllerFields[CF_COUNT] = {
+    {  0, sizeof(ControllerData::currentTemp) },
+    {  4, sizeof(ControllerData::setpoint) },
+    {  8, sizeof(ControllerData::output) },
+    { 12, sizeof(ControllerData::kp) },
+    { 16, sizeof(ControllerData::ki) },
+    { 20, sizeof(ControllerData::kd) },
+    { 24, sizeof(ControllerData::isRunning) },
+    { 25, sizeof(ControllerData::isLogging) },
+    { 26, sizeof(ControllerData::errorState) },
+    { 27, sizeof(ControllerData::testDuration) },
+};
+
+constexpr bool controllerFieldsPacked(int f = 0) {
+    return f == CF_COUNT - 1 ||
+           (controllerFields[f].offset + controllerFields[f].size == controllerFields[f + 1].offset &&
+            controllerFieldsPacked(f + 1));
+}
+static_assert(sizeof(float) == 4, "floats go on the wire as IEEE 754 binary32");
+static_assert(controllerFields[0].offset == 0 && controllerFieldsPacked(),
+              "controllerFields must tile the wire format without gaps");
+static_assert(controllerFields[CF_COUNT - 1].offset + controllerFields[CF_COUNT - 1].size == CONTROLLER_WIRE_SIZE,
+              "CONTROLLER_WIRE_SIZE does not match controllerFields");
+
+static inline uint16_t getLe16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline void putLe16(uint8_t *p, uint16_t v) {
+    p[0] = v; p[1] = v >> 8;
+}
+
+static inline uint32_t getLe32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void putLe32(uint8_t *p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static inline float getLeFloat(const uint8_t *p) {
+    uint32_t bits = getLe32(p);
+    float f;
+    memcpy(&f, &bits, 4);
+    return f;
+}
+
+static inline void putLeFloat(uint8_t *p, float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, 4);
+    putLe32(p, bits);
+}
+
+// Reads one field from its wire bytes at p.
+static inline void decodeField(ControllerData &d, ControllerField f, const uint8_t *p) {
+    switch (f) {
+        case CF_CURRENT_TEMP:   d.currentTemp = getLeFloat(p); break;
+        case CF_SETPOINT:       d.setpoint = getLeFloat(p); break;
+        case CF_OUTPUT:         d.output = getLeFloat(p); break;
+        case CF_KP:             d.kp = getLeFloat(p); break;
+        case CF_KI:             d.ki = getLeFloat(p); break;
+        case CF_KD:             d.kd = getLeFloat(p); break;
+        case CF_IS_RUNNING:     d.isRunning = p[0]; break;
+        case CF_IS_LOGGING:     d.isLogging = p[0]; break;
+        case CF_ERROR_STATE:    d.errorState = p[0]; break;
+        case CF_TEST_DURATION:  d.testDuration = getLe32(p); break;
+        default: break;
+    }
+}
+
+// Writes one field's wire bytes to p.
+static inline void encodeField(const ControllerData &d, ControllerField f, uint8_t *p) {
+    switch (f) {
+        case CF_CURRENT_TEMP:   putLeFloat(p, d.currentTemp); break;
+        case CF_SETPOINT:       putLeFloat(p, d.setpoint); break;
+        case CF_OUTPUT:         putLeFloat(p, d.output); break;
+        case CF_KP:             putLeFloat(p, d.kp); break;
+        case CF_KI:             putLeFloat(p, d.ki); break;
+        case CF_KD:             putLeFloat(p, d.kd); break;
+        case CF_IS_RUNNING:     p[0] = d.isRunning; break;
+        case CF_IS_LOGGING:     p[0] = d.isLogging; break;
+        case CF_ERROR_STATE:    p[0] = d.errorState; break;
+        case CF_TEST_DURATION:  putLe32(p, d.testDuration); break;
+        default: break;
+    }
+}
+
+// --- COMMANDS ---
+// Each command carries a sequence number. The mainboard carries out a
+// command only if its sequence number differs from the last one it
+// received, and always answers in REG_ACK, so the dial can resend the
+// same frame until it sees the ack without the command taking effect
+// twice. On the wire a command is seq, type, then the arguments its type
+// takes as little endian floats; see encodeCommand().
+enum CommandType : uint8_t {
+    CMD_SET_SETPOINT = 1,   // args[0] = setpoint
+    CMD_SET_GAINS    = 2,   // args[0..2] = kp, ki, kd
+    CMD_START_TEST   = 3,
+    CMD_STOP_TEST    = 4,
+};
+
+enum CommandStatus : uint8_t {
+    CMD_OK       = 0,
+    CMD_REJECTED = 1,       // arguments out of range or not allowed right now
+    CMD_UNKNOWN  = 2,       // unknown command type
+};
+
+struct ControllerCommand {
+    uint8_t seq;            // never 0, so it cannot match a freshly reset REG_ACK
+    uint8_t type;           // CommandType
+    float args[3];
+};
+
+struct CommandAck {
+    uint8_t seq;            // of the last command received
+    uint8_t status;         // CommandStatus
+};
+#define COMMAND_ACK_WIRE_SIZE 2
+
+static inline CommandAck decodeAck(const uint8_t *p) { return { p[0], p[1] }; }
+static inline void encodeAck(const CommandAck &a, uint8_t *p) { p[0] = a.seq; p[1] = a.status; }
+
+static inline int commandArgCount(uint8_t type) {
+    switch (type) {
+        case CMD_SET_SETPOINT: return 1;
+        case CMD_SET_GAINS:    return 3;
+        default:               return 0;
+    }
+}
+
+#define COMMAND_WIRE_MAX (2 + 3 * 4)
+
+// Writes cmd's wire bytes to p (COMMAND_WIRE_MAX bytes); returns how many.
+static inline uint8_t encodeCommand(const ControllerCommand &cmd, uint8_t *p) {
+    int args = commandArgCount(cmd.type);
+    p[0] = cmd.seq;
+    p[1] = cmd.type;
+    for (int i = 0; i < args; i++) putLeFloat(p + 2 + 4 * i, cmd.args[i]);
+    return 2 + 4 * args;
+}
+
+// --- HISTORY ---
+// The mainboard keeps a ring of one HistorySample per second and numbers
+// them from boot. To fetch a page the dial writes the number of the first
+// sample it wants to REG_HISTORY_SELECT, then reads REG_HISTORY with the
+// length for as many samples as it wants (at most HISTORY_PAGE_SAMPLES).
+// If the selected sample has already left the ring the page starts at the
+// oldest one still held; `first` says which.
+// On the wire: HistoryInfo is newest (LE32), count (LE16); REG_HISTORY is
+// first (LE32) then temp, output (LE16 each) per sample.
+struct HistoryInfo {
+    uint32_t newest;        // number of the newest sample
+    uint16_t count;         // samples held, ending at newest
+};
+#define HISTORY_INFO_WIRE_SIZE 6
+
+struct HistorySample {
+    int16_t temp;           // currentTemp in 0.1 C
+    int16_t output;         // output * 10
+};
+#define HISTORY_SAMPLE_WIRE_SIZE 4
+
+static inline HistoryInfo decodeHistoryInfo(const uint8_t *p) { return { getLe32(p), getLe16(p + 4) }; }
+static inline void encodeHistoryInfo(const HistoryInfo &h, uint8_t *p) { putLe32(p, h.newest); putLe16(p + 4, h.count); }
+static inline HistorySample decodeHistorySample(const uint8_t *p) { return { (int16_t)getLe16(p), (int16_t)getLe16(p + 2) }; }
+static inline void encodeHistorySample(const HistorySample &s, uint8_t *p) { putLe16(p, s.temp); putLe16(p + 2, s.output); }
+
+// --- FRAMING ---
+// Every transfer in either direction is one frame:
+//   FrameHeader, payload[len], CRC-16/CCITT-FALSE of header and payload (LE)
+// A write is a frame with reg = the register and the bytes to write.
+// A read is a frame with reg = register | FRAME_READ, len = bytes wanted and
+// no payload, after which the dial reads the reply: a frame echoing version,
+// seq and reg (without FRAME_READ) carrying len bytes. Either side drops a
+// frame whose version, header or CRC does not check out; the mainboard
+// then does not act on it and the dial counts it.
+#define FRAME_READ 0x80
+#define FRAME_MAX_PAYLOAD 120      // a frame fits the 128 byte Wire buffers
+
+#pragma pack(push, 1)
+struct FrameHeader {
+    uint8_t version;        // CONTROLLER_PROTOCOL_VERSION
+    uint8_t seq;            // per transfer, echoed in read replies
+    uint8_t reg;
+    uint8_t len;
+};
 #pragma pack(pop)
 
+static_assert(sizeof(FrameHeader) == 4, "FrameHeader must not be padded");
+
+const size_t FRAME_OVERHEAD = sizeof(FrameHeader) + 2;
+
+#define HISTORY_PAGE_SAMPLES ((FRAME_MAX_PAYLOAD - 4) / HISTORY_SAMPLE_WIRE_SIZE)
+
+// Each register's bytes, as far as a transfer auto-increments through
+// them, must end before the next register starts.
+static_assert(REG_CHANGED + 2 <= REG_ACK, "REG_CHANGED overlaps REG_ACK");
+static_assert(REG_ACK + COMMAND_ACK_WIRE_SIZE <= REG_COMMAND, "REG_ACK overlaps REG_COMMAND");
+static_assert(REG_COMMAND + COMMAND_WIRE_MAX <= REG_DATA, "REG_COMMAND overlaps REG_DATA");
+static_assert(REG_DATA + CONTROLLER_WIRE_SIZE <= REG_HISTORY_INFO, "REG_DATA overlaps REG_HISTORY_INFO");
+static_assert(REG_HISTORY_INFO + HISTORY_INFO_WIRE_SIZE <= REG_HISTORY_SELECT, "REG_HISTORY_INFO overlaps REG_HISTORY_SELECT");
+static_assert(REG_HISTORY_SELECT + 4 <= REG_HISTORY, "REG_HISTORY_SELECT overlaps REG_HISTORY");
+static_assert(REG_HISTORY + FRAME_MAX_PAYLOAD <= 0x100 && REG_HISTORY < FRAME_READ,
+              "REG_HISTORY runs past the register space");
+
+static inline uint16_t frameCrc(const uint8_t *p, size_t n) {
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc ^= (uint16_t)(*p++) << 8;
+        for (int i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
 #endif
@@ -0,0 +1,197 @@
+#ifndef TEST_LOG_H
+#define TEST_LOG_H
+
+#include <stdint.h>
+
+// --- ON-FLASH TEST LOG FORMAT ---
+// Every run (a zone running a test, or asked to log by the mainboard) is
+// one append-only file TEST_LOG_DIR/<run>, a sequence of LogPages, each
+// written and flushed whole once it is full or TEST_LOG_PAGE_MAX_SECONDS
+// after its first record (and the last one when the run ends), so a power
+// cut loses at most that much of a run. A page is never rewritten.
+//
+// TEST_LOG_INDEX holds one LogRunEntry per run, appended when the run
+// starts and rewritten in place when it ends, so the runs on flash and
+// whether each was closed cleanly are known without opening the logs. A
+// run still open at boot was cut short; its page count is then taken from
+// the file size and only its last page is checked.
+//
+// All fields little endian.
+#define TEST_LOG_DIR "/runs"
+#define TEST_LOG_INDEX "/runs/index"
+#define TEST_LOG_PAGE_SIZE 256
+#define TEST_LOG_MAGIC 0x5A54      // "TZ", pages of LogEncoder records
+#define TEST_LOG_MAX_RECORDS 255   // per page, as header.count holds it
+#define TEST_LOG_PAGE_MAX_SECONDS 120
+
+// One sample, in fixed point
+struct LogRecord {
+    uint32_t seconds;       // since the run started
+    int16_t temp;           // currentTemp in 0.1 C
+    int16_t setpoint;       // 0.1 C
+    int16_t output;         // output * 10
+    uint8_t errorState;
+};
+
+#pragma pack(push, 1)
+struct LogPageHeader {
+    uint16_t magic;         // TEST_LOG_MAGIC
+    uint16_t run;
+    uint32_t page;          // 0, 1, ... within the run
+    uint8_t zone;
+    uint8_t count;          // records encoded in data
+    uint16_t crc;           // frameCrc() of the page with this field 0
+};
+
+struct LogPage {
+    LogPageHeader header;
+    uint8_t data[TEST_LOG_PAGE_SIZE - sizeof(LogPageHeader)];
+};
+
+enum LogRunFlags : uint8_t {
+    LOG_RUN_CLOSED = 0x01,  // the run ended, or was recovered at boot
+};
+
+struct LogRunEntry {
+    uint16_t run;
+    uint8_t zone;
+    uint8_t flags;          // LogRunFlags
+    uint32_t pages;         // valid pages in the log, set when closed
+};
+#pragma pack(pop)
+
+static_assert(sizeof(LogPageHeader) == 12, "LogPageHeader must not be padded");
+static_assert(sizeof(LogPage) == TEST_LOG_PAGE_SIZE, "LogPage must fill a page");
+
+// --- RECORD CODEC ---
+// The records of a page are a bit stream, most significant bit first. Each
+// field is coded against the record before it, the first record of a page
+// against zeros, so every page decodes on its own:
+//
+//   seconds                  delta of delta   0 | 10 + 7 | 11 + 32 (value)
+//   temp, setpoint, output   delta            0 | 10 + 4 | 110 + 8 | 111 + 16 (value)
+//   errorState               repeat           0 | 1 + 8 (value)
+//
+// Deltas are zigzag coded (0, -1, 1, -2 .. as 0, 1, 2, 3 ..); where they
+// do not fit, the longest code carries the value itself. A second of a
+// steady test costs 5 to 15 bits against 16 bytes for the same fields as
+// a time stamp and four floats; with pages cut at TEST_LOG_PAGE_MAX_SECONDS
+// that comes to about 2 bytes a second on flash.
+struct LogCodecState {
+    uint32_t seconds;
+    int32_t secondsDelta;
+    int16_t temp, setpoint, output;
+    uint8_t errorState;
+    uint16_t bit;           // position in LogPage::data
+};
+
+static inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+class LogEncoder {
+public:
+    // Call with each new page
+    void reset() { s = LogCodecState(); }
+
+    // Adds r to page, or returns false and leaves it as it was if r does
+    // not fit. The page's data must start zeroed.
+    bool append(LogPage &page, const LogRecord &r) {
+        Code codes[5];
+        int32_t delta = (int32_t)(r.seconds - s.seconds);
+        uint32_t dod = zigzag(delta - s.secondsDelta);
+        if (dod == 0) codes[0] = { 0, 1 };
+        else if (dod < (1 << 7)) codes[0] = { (0x2ull << 7) | dod, 9 };
+        else codes[0] = { (0x3ull << 32) | r.seconds, 34 };
+        codes[1] = valueCode(r.temp, s.temp);
+        codes[2] = valueCode(r.setpoint, s.setpoint);
+        codes[3] = valueCode(r.output, s.output);
+        codes[4] = r.errorState == s.errorState ? Code{ 0, 1 } : Code{ 0x100u | r.errorState, 9 };
+
+        int length = 0;
+        for (const Code &c : codes) length += c.length;
+        if (page.header.count >= TEST_LOG_MAX_RECORDS || s.bit + length > (int)sizeof(page.data) * 8) return false;
+        for (const Code &c : codes) {
+            for (int i = c.length - 1; i >= 0; i--, s.bit++) {
+                if ((c.bits >> i) & 1) page.data[s.bit >> 3] |= 0x80 >> (s.bit & 7);
+            }
+        }
+        page.header.count++;
+        s.secondsDelta = delta;
+        s.seconds = r.seconds;
+        s.temp = r.temp; s.setpoint = r.setpoint; s.output = r.output;
+        s.errorState = r.errorState;
+        return true;
+    }
+
+private:
+    struct Code { uint64_t bits; int length; };
+
+    static Code valueCode(int16_t v, int16_t last) {
+        uint32_t z = zigzag((int32_t)v - last);
+        if (z == 0) return { 0, 1 };
+        if (z < (1 << 4)) return { (0x2u << 4) | z, 6 };
+        if (z < (1 << 8)) return { (0x6u << 8) | z, 11 };
+        return { (0x7ull << 16) | (uint16_t)v, 19 };
+    }
+
+    LogCodecState s = {};
+};
+
+class LogDecoder {
+public:
+    explicit LogDecoder(const LogPage &page) : page(page) {}
+
+    // The next record of the page; false after header.count of them, or
+    // if the data runs out first.
+    bool next(LogRecord &r) {
+        if (left == 0) return false;
+        left--;
+        if (!bit()) {
+            s.seconds += s.secondsDelta;
+        } else if (!bit()) {
+            s.secondsDelta += unzigzag(bits(7));
+            s.seconds += s.secondsDelta;
+        } else {
+            uint32_t seconds = bits(32);
+            s.secondsDelta = (int32_t)(seconds - s.seconds);
+            s.seconds = seconds;
+        }
+        s.temp = value(s.temp);
+        s.setpoint = value(s.setpoint);
+        s.output = value(s.output);
+        if (bit()) s.errorState = bits(8);
+        if (overrun) return false;
+        r.seconds = s.seconds;
+        r.temp = s.temp; r.setpoint = s.setpoint; r.output = s.output;
+        r.errorState = s.errorState;
+        return true;
+    }
+
+private:
+    uint32_t bit() {
+        if (s.bit >= sizeof(page.data) * 8) { overrun = true; return 0; }
+        uint32_t b = (page.data[s.bit >> 3] >> (7 - (s.bit & 7))) & 1;
+        s.bit++;
+        return b;
+    }
+
+    uint32_t bits(int n) {
+        uint32_t v = 0;
+        while (n--) v = (v << 1) | bit();
+        return v;
+    }
+
+    int16_t value(int16_t last) {
+        if (!bit()) return last;
+        if (!bit()) return last + unzigzag(bits(4));
+        if (!bit()) return last + unzigzag(bits(8));
+        return (int16_t)bits(16);
+    }
+
+    const LogPage &page;
+    LogCodecState s = {};
+    int left = page.header.count;
+    bool overrun = false;
+};
+
+#endif
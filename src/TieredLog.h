@@ -0,0 +1,106 @@
+#ifndef TIERED_LOG_H
+#define TIERED_LOG_H
+
+#include <stdint.h>
+#include "RingBuffer.h"
+
+// A sample history at several resolutions. Tier 0 has a bucket per sample
+// (one a second); each further tier has one per bucketSeconds(tier) seconds,
+// rolled up from the tier below as samples arrive. A bucket keeps the min,
+// max and mean of what it covers, and every tier holds its last N buckets,
+// so tier t spans N * bucketSeconds(t) seconds and can be drawn as is.
+// Only the lowest low and highest high of a tier are ever asked for, so
+// the means track neither.
+template <int N>
+class TieredLog {
+public:
+    static const int TIERS = 4;
+
+    struct Tier {
+        RingBuffer<float, N, RING_MIN> lows;
+        RingBuffer<float, N, RING_MAX> highs;
+        RingBuffer<float, N, RING_PLAIN> means;
+        float low, high, sum;   // the bucket being filled
+        int seconds;            // covered by it so far
+    };
+
+    static int bucketSeconds(int tier) {
+        static const int seconds[TIERS] = { 1, 10, 60, 600 };
+        return seconds[tier];
+    }
+
+    // The finest tier that spans `seconds`, or the coarsest.
+    static int tierFor(uint32_t seconds) {
+        for (int t = 0; t < TIERS - 1; t++) {
+            if ((uint32_t)N * bucketSeconds(t) >= seconds) return t;
+        }
+        return TIERS - 1;
+    }
+
+    const Tier &tier(int t) const { return tiers[t]; }
+
+    void push(float v) { add(0, v, v, v, 1); }
+
+    // Fills tier 0 with v without rolling anything up, as a flat line to
+    // show before there are samples.
+    void fill(float v) {
+        for (int i = 0; i < N; i++) pushBucket(tiers[0], v, v, v);
+    }
+
+    // Replaces the newest part of every tier with history's: a log built
+    // with push() from another record of the same samples (the mainboard's,
+    // up to now), so every tier gets them rolled up just as if they had
+    // been pushed live. Buckets older than history reaches are kept.
+    void backfill(const TieredLog &history) {
+        float scratch[N];
+        for (int i = 0; i < TIERS; i++) {
+            Tier &t = tiers[i];
+            const Tier &h = history.tiers[i];
+            int keep = t.means.size() - h.means.size();
+            if (keep < 0) keep = 0;
+            splice(t.lows, h.lows, keep, scratch);
+            splice(t.highs, h.highs, keep, scratch);
+            splice(t.means, h.means, keep, scratch);
+            t.low = h.low; t.high = h.high; t.sum = h.sum;
+            t.seconds = h.seconds;
+        }
+    }
+
+private:
+    // Keeps the oldest `keep` of dst and appends all of src.
+    template <typename Ring>
+    static void splice(Ring &dst, const Ring &src, int keep, float *scratch) {
+        dst.copyTo(scratch);
+        dst.clear();
+        for (int i = 0; i < keep; i++) dst.push(scratch[i]);
+        for (int i = 0; i < src.size(); i++) dst.push(src[i]);
+    }
+
+    static void pushBucket(Tier &t, float low, float high, float mean) {
+        t.lows.push(low);
+        t.highs.push(high);
+        t.means.push(mean);
+    }
+
+    void add(int index, float low, float high, float mean, int seconds) {
+        Tier &t = tiers[index];
+        if (t.seconds == 0) {
+            t.low = low; t.high = high; t.sum = 0;
+        } else {
+            if (low < t.low) t.low = low;
+            if (high > t.high) t.high = high;
+        }
+        t.sum += mean * seconds;
+        t.seconds += seconds;
+        if (t.seconds < bucketSeconds(index)) return;
+
+        float bucketMean = t.sum / t.seconds;
+        pushBucket(t, t.low, t.high, bucketMean);
+        t.seconds = 0;
+        if (index + 1 < TIERS) add(index + 1, t.low, t.high, bucketMean, bucketSeconds(index));
+    }
+
+    Tier tiers[TIERS] = {};
+};
+
+#endif
@@ -7,53 +7,141 @@
 #include "M5GFX.h"
 #include <TFT_eSPI.h>
 #include <EEPROM.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <new>
+#include "Mailbox.h"
+#include "TieredLog.h"
+#include "SharedData.h"
+#include "TestLog.h"
 
 TFT_eSPI tft = TFT_eSPI();
 TFT_eSprite spr = TFT_eSprite(&tft);
+const int bandRows = 40;    // spr holds one strip of this many rows, see renderRegion()
 
 // --- I2C / SHARED DATA ---
-#define I2C_ADDR_MAINBOARD 0x42
-
-#pragma pack(push, 1)
-struct ControllerData {
-    float currentTemp;
-    float setpoint;
-    float output;
-    float kp;
-    float ki;
-    float kd;
-    uint8_t isRunning;   // CHANGED: bool -> uint8_t (0=Off, 1=On)
-    uint8_t isLogging;   // CHANGED: bool -> uint8_t (0=Off, 1=On)
-    uint8_t errorState;
-    uint32_t testDuration;
-};
-#pragma pack(pop)
-
+// ControllerData and the register map are shared with the mainboard, see SharedData.h
+// One zone per mainboard found at startup. `data` and `i2cConnected` are the
+// working copy of the zone on screen, zoneData[] the latest of every zone.
+const int maxZones = MAINBOARD_ADDR_COUNT;
+int zoneCount = 1;          // set once by scanControllers() in setup()
+int activeZone = 0;
 ControllerData data;
 bool i2cConnected = false;
+ControllerData zoneData[maxZones];
+bool zoneConnected[maxZones];
 unsigned long lastSync = 0;
 
+// --- I2C ENGINE ---
+// All bus traffic runs in its own task so a slow or absent mainboard only
+// ever delays that task, never loop(). The task polls the controller at the
+// rate pollInterval() picks and sends queued commands in between, one at a
+// time until each is acknowledged; each poll result is handed back through
+// a mailbox, and only when something changed. Zones are polled round
+// robin, each at its own rate.
+// I2C_TASK_CORE -1 runs the same steps inline from loop() instead.
+#ifndef I2C_TASK_CORE
+#define I2C_TASK_CORE 1
+#endif
+const unsigned long i2cFastPollMs = 30;     // editing, or a running test ramping
+const unsigned long i2cPollMs = 200;        // running, or temperature drifting
+const unsigned long i2cIdlePollMs = 1500;   // idle and stable
+const unsigned long i2cMaxBackoffMs = 2000; // disconnected, doubling from i2cPollMs
+#ifndef I2C_CLOCK_HZ
+#define I2C_CLOCK_HZ 100000
+#endif
+const float rampSlewCPerS = 0.5;
+const float stableSlewCPerS = 0.05;
+// Optional attention line from the mainboard, held low while REG_CHANGED is
+// non-zero. When wired, its falling edge starts a read straight away and the
+// timed poll is only a heartbeat that notices a lost connection.
+#ifndef CONTROLLER_DRDY_PIN
+#define CONTROLLER_DRDY_PIN -1
+#endif
+const unsigned long i2cHeartbeatMs = 1000;
+const unsigned long commandRetryMs = 20;    // between ack checks / resends
+const int commandAttempts = 5;
+const unsigned long commandHoldMs = 3000;   // a command waits this long for a lost link
+const int linkFailLimit = 4;        // failed polls in a row before a zone is gone
+const int i2cQueueLength = 8;
+struct I2cPoll {
+    bool connected[maxZones];
+    ControllerData data[maxZones];
+};
+struct ZoneCommand {
+    uint8_t zone;
+    ControllerCommand cmd;
+};
+QueueHandle_t i2cCommands = nullptr;    // ZoneCommand, loop -> I2C task
+Mailbox<I2cPoll> i2cPolls;          // I2C task -> loop
+std::atomic<bool> controllerDataReady(false);   // set from the DRDY interrupt
+std::atomic<bool> i2cUserEditing(false);    // loop -> I2C task, asks for fast polls
+std::atomic<int> i2cActiveZone(0);          // loop -> I2C task, the zone on screen
+std::atomic<uint32_t> i2cIntervalMs(i2cPollMs); // I2C task -> Diagnostics
+std::atomic<uint32_t> i2cBusPermille(0);    // share of the last second spent in transfers
+std::atomic<uint32_t> i2cBadFrames(0);      // replies dropped for a bad header or CRC
+#if I2C_TASK_CORE >= 0
+TaskHandle_t i2cTaskHandle = nullptr;
+#endif
+
 // --- STATE MANAGEMENT ---
 enum ScreenState {
     MAIN_SCREEN, USER_MENU, SET_TEMP, SET_TIME, LOG_GRAPH,
     CONFIRM_START_TEST, SERVICE_MENU_LOGIN, SERVICE_MENU,
-    PID_SELECT_MENU, SET_KP, SET_KI, SET_KD
+    PID_SELECT_MENU, SET_KP, SET_KI, SET_KD, DIAGNOSTICS
 };
 ScreenState currentScreen = MAIN_SCREEN;
 
+// --- FRAME SCHEDULER ---
+// Frames are only produced for a screen whose invalidation bit is set
+// (I2C data change, encoder move, timer tick, screen change), and never
+// faster than UI_MAX_FPS. Drawing runs in its own task pinned to
+// UI_RENDER_CORE (the Arduino loop runs on the other core); -1 renders
+// inline from loop() instead.
+#ifndef UI_MAX_FPS
+#define UI_MAX_FPS 30
+#endif
+#ifndef UI_RENDER_CORE
+#define UI_RENDER_CORE 0
+#endif
+// Follow-up frames of a running animation (menu scrolling) are paced by
+// UI_ANIM_FPS instead.
+#ifndef UI_ANIM_FPS
+#define UI_ANIM_FPS 60
+#endif
+const unsigned long frameIntervalMs = 1000 / UI_MAX_FPS;
+const unsigned long animFrameIntervalMs = 1000 / UI_ANIM_FPS;
+uint16_t dirtyScreens = 0;        // one bit per ScreenState, loop side
+std::atomic<uint32_t> uiDirty(0); // bits handed to the renderer
+// Invalidations of the shown screen that arrived while an earlier one was
+// still waiting to be drawn, so both got one frame; counted by whichever
+// side sees the overlap
+std::atomic<uint32_t> framesCoalesced(0);
+#if UI_RENDER_CORE >= 0
+TaskHandle_t renderTaskHandle = nullptr;
+#endif
+
+// Render side only: the renderer's pending bits, counters and retained state
+uint16_t pendingScreens = 0;
+unsigned long lastFrame = 0;
+unsigned long framesRendered = 0;
+unsigned long lastFrameMicros = 0;
+bool animating = false;           // the shown screen asked for another frame
+int shownScreen = -1;             // ScreenState on the panel, -1 after a message screen
+
 // --- MENU VARS ---
 unsigned short grays[15];
 
 int userMenuSelection = 0;
-String userMenuItems[] = {"Set Temperature", "Set Time", "Logging", "Run Test", "Service Menu", "Back"};
+const char *userMenuItems[] = {"Set Temperature", "Set Time", "Logging", "Run Test", "Service Menu", "Back"};
 const int userMenuSize = 6;
 
 int serviceMenuSelection = 0;
-String serviceMenuItems[] = {"Set PID", "Diagnostics", "Back"};
+const char *serviceMenuItems[] = {"Set PID", "Diagnostics", "Back"};
 const int serviceMenuSize = 3;
 
 int pidMenuSelection = 0;
-String pidMenuItems[] = {"Set Kp", "Set Ki", "Set Kd", "Back"};
+const char *pidMenuItems[] = {"Set Kp", "Set Ki", "Set Kd", "Back"};
 const int pidMenuSize = 4;
 
 int confirmMenuSelection = 0;
@@ -67,6 +155,16 @@ unsigned long passwordFailTime = 0;
 const char* charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 const int charsetSize = 36;
 
+// --- VALUE EDITORS ---
+struct ValueEditor {
+    const char *title;
+    float *target;
+    const char *unit;
+    float step;
+    float maxVal;
+};
+ValueEditor editorFor(ScreenState screen, ControllerData &d);
+
 // --- SETTINGS ---
 int timeSettingMinutes = 30;
 long oldPosition = 0;
@@ -74,45 +172,182 @@ long oldPosition = 0;
 const int TIME_ADDR = 4;
 
 // --- LOGGING VISUALS ---
-const int logDataPoints = 200;
-float logData[logDataPoints];
+// One sample per second per zone, kept at the resolutions in TieredLog.h
+// for up to a day, in PSRAM where there is any. The graph draws the finest
+// tier that spans the current (or last) test. The logs are allocated last
+// in setup(); without PSRAM a zone only gets one while logHeapReserve of
+// internal RAM stays free for the DMA strips, task stacks and the rest.
+const int logDataPoints = 200;      // buckets per tier
+typedef TieredLog<logDataPoints> ZoneLog;
+ZoneLog *logData[maxZones];         // nullptr if it could not be allocated
+const size_t logHeapReserve = 64 * 1024;
+const int graphPad = 20;
+const int graphWidth = 240 - 2 * graphPad;  // pixel columns of the plot
+// After a (re)connect the I2C task downloads the mainboard's own record
+// of as much as the zone's graph tier spans, rolls it up into a ZoneLog of
+// its own and hands that over to backfill logData; loop() frees it.
+struct I2cHistory {
+    int zone;
+    ZoneLog *log;
+};
+QueueHandle_t i2cHistory = nullptr;     // I2cHistory, I2C task -> loop
+
+// --- TEST LOG ---
+// Every run also goes to flash (LittleFS, which spreads the wear) in the
+// format of TestLog.h. Samples are encoded into a page in RAM as they come
+// and the page is written once full or TEST_LOG_PAGE_MAX_SECONDS old, so a
+// power cut loses at most two minutes of a run and flash sees a write
+// every two minutes or so per zone.
+struct TestRun {
+    bool open;
+    uint16_t run;
+    unsigned long startMs;
+    LogPage page;                   // being filled; header.page = pages written
+    unsigned long pageStartMs;      // when the page got its first record
+    LogEncoder encoder;
+};
+TestRun testRuns[maxZones];
+bool testLogReady = false;          // LittleFS mounted
+uint16_t nextTestRun = 1;
+const size_t testLogMaxUsedPercent = 75;    // oldest runs are deleted beyond this
+
+// --- UI SNAPSHOT ---
+// Everything the draw* functions read. loop() fills one whenever a screen
+// is invalidated and hands it to the render task through a lock-free
+// mailbox; the renderer only ever reads its own copy (`view`).
+struct UiSnapshot {
+    ScreenState screen;
+    ControllerData data;
+    bool i2cConnected;
+    int zone;
+    int zoneCount;
+    uint32_t pollIntervalMs;
+    uint32_t busPermille;
+    uint32_t badFrames;
+    bool passwordFail;
+    int timeSettingMinutes;
+    int userMenuSelection;
+    int serviceMenuSelection;
+    int pidMenuSelection;
+    int confirmMenuSelection;
+    int passwordCharIndex;
+    int passwordLength;
+    const char *userMenu[userMenuSize];
+    // The shown tier decimated to one bucket per plot column, see
+    // decimateLog()
+    bool logValid;
+    float logMean[graphWidth];
+    float logLow[graphWidth];
+    float logHigh[graphWidth];
+    float logMin, logMax;
+};
+Mailbox<UiSnapshot> uiMailbox;
+UiSnapshot view;
 
 // Forward Declarations
-void drawMainScreen();
-void drawRotaryMenu(const char *title, String items[], int numItems, int selection);
+void initDisplayTransfer();
+template <typename Draw> void renderRegion(int top, int height, Draw draw);
+template <typename Draw> void renderRect(int x, int y, int w, int h, Draw draw);
+void drawMainScreen(bool fresh);
+void drawMainFields();
+void drawRotaryMenu(const char *title, const char *items[], int numItems, int selection);
+bool scrollMenu(bool fresh, int selection);
 void drawPasswordScreen();
+void updatePasswordScreen(bool fresh);
 void drawMessageScreen(const char* msg1, const char* msg2, uint16_t color);
 void drawConfirmationScreen(const char* title, const char* option1, const char* option2, int selection);
-void drawValueEditor(const char *title, float &value, const char *unit, float step, float maxVal);
+void drawValueEditor(const char *title, float value, const char *unit, float step, float maxVal);
 void drawTimeEditor();
 void drawLogGraph();
+void drawDiagnostics();
+enum FontId : uint8_t;
+void cacheFonts();
+void useFont(FontId id);
+void buildBigAtlas();
+#ifdef UI_BENCHMARK
+void benchmarkFontCache();
+#endif
+bool drawBigText(const char *text, int x, int y, uint8_t datum, uint16_t fg, uint16_t bg);
+void invalidate(ScreenState screen);
+void showScreen(ScreenState screen);
+void serviceFrame();
+unsigned long renderStep();
+#if UI_RENDER_CORE >= 0
+void renderTask(void *);
+#endif
+void allocateLogs();
 void saveLocalSettings();
 void loadLocalSettings();
+void beginTestLog();
+void serviceTestLog(unsigned long now);
 void syncWithController();
-void sendToController();
+void backfillLog(const I2cHistory &history);
+void sendCommand(CommandType type, float a = 0, float b = 0, float c = 0);
+void sendZoneCommand(int zone, CommandType type, float a = 0, float b = 0, float c = 0);
+ControllerData &zoneState(int zone);
+void selectZone(int zone);
+void scanControllers();
+unsigned long i2cStep();
+#if I2C_TASK_CORE >= 0
+void i2cTask(void *);
+#endif
+void onControllerDataReady();
+void wakeI2c();
 
 // ================= SETUP & LOOP =================
 
 void setup() {
     auto cfg = M5.config();
     M5Dial.begin(cfg, true, true);
-    spr.createSprite(240, 240);
+    spr.createSprite(240, bandRows);
 
     // Init I2C (Master) - M5Dial Internal I2C is usually 13/14
     Wire.begin(13, 15);
+    Wire.setClock(I2C_CLOCK_HZ);
+    scanControllers();
+    i2cCommands = xQueueCreate(i2cQueueLength, sizeof(ZoneCommand));
+    i2cHistory = xQueueCreate(maxZones, sizeof(I2cHistory));
 
     int co = 225;
     for (int i = 0; i < 15; i++) { grays[i] = tft.color565(co, co, co); co -= 15; }
-    for (int i = 0; i < logDataPoints; i++) { logData[i] = 25.0; }
+    cacheFonts();
+    buildBigAtlas();
+#ifdef UI_BENCHMARK
+    benchmarkFontCache();
+#endif
 
     loadLocalSettings();
+    beginTestLog();
     M5Dial.Speaker.setVolume(180);
 
     // Default Fallbacks
     data.setpoint = 100.0;
     data.kp = 10.0; data.ki = 0.5; data.kd = 2.0;
-
-    drawMainScreen();
+    for (int z = 0; z < maxZones; z++) zoneData[z] = data;
+
+    invalidate(MAIN_SCREEN);
+    // A task that cannot be created leaves a null handle; its steps then
+    // run inline from loop(), as with core -1
+#if UI_RENDER_CORE >= 0
+    if (xTaskCreatePinnedToCore(renderTask, "render", 8192, nullptr, 1, &renderTaskHandle, UI_RENDER_CORE) != pdPASS) {
+        renderTaskHandle = nullptr;
+        Serial.println("No render task, rendering from loop()");
+        initDisplayTransfer();
+    }
+#else
+    initDisplayTransfer();
+#endif
+#if I2C_TASK_CORE >= 0
+    if (xTaskCreatePinnedToCore(i2cTask, "i2c", 4096, nullptr, 2, &i2cTaskHandle, I2C_TASK_CORE) != pdPASS) {
+        i2cTaskHandle = nullptr;
+        Serial.println("No I2C task, polling from loop()");
+    }
+#endif
+#if CONTROLLER_DRDY_PIN >= 0
+    pinMode(CONTROLLER_DRDY_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(CONTROLLER_DRDY_PIN), onControllerDataReady, FALLING);
+#endif
+    allocateLogs();
 }
 
 void loop() {
@@ -120,48 +355,70 @@ void loop() {
     unsigned long now = millis();
 
     // --- I2C SYNC ---
+    bool editing = (currentScreen == SET_TEMP || currentScreen == SET_KP ||
+                    currentScreen == SET_KI || currentScreen == SET_KD);
+    if (i2cUserEditing.exchange(editing) != editing) wakeI2c();
+#if I2C_TASK_CORE < 0
+    i2cStep();
+#else
+    if (!i2cTaskHandle) i2cStep();
+#endif
+    syncWithController();
+    I2cHistory history;
+    while (xQueueReceive(i2cHistory, &history, 0) == pdTRUE) backfillLog(history);
     if (now - lastSync > 200) {
         lastSync = now;
-        syncWithController();
 
         // Update Graph Data
         static unsigned long lastGraph = 0;
-        if (now - lastGraph > 1000) {
-            lastGraph = now;
-            for (int i = 0; i < logDataPoints - 1; i++) logData[i] = logData[i+1];
-            logData[logDataPoints - 1] = data.currentTemp;
-
-            // Auto Stop Timer Logic
-            if (data.isRunning && data.testDuration > (timeSettingMinutes * 60)) {
-                data.isRunning = false;
-                sendToController();
-                M5Dial.Speaker.tone(4000, 1000);
-                currentScreen = MAIN_SCREEN;
+        if (now - lastGraph >= 1000) {
+            // Keep a 1 Hz average so the tiers' bucket lengths hold
+            lastGraph += 1000;
+            if (now - lastGraph >= 1000) lastGraph = now;
+            for (int z = 0; z < zoneCount; z++) {
+                if (logData[z]) logData[z]->push(zoneState(z).currentTemp);
+            }
+            serviceTestLog(now);
+            invalidate(LOG_GRAPH);
+            invalidate(MAIN_SCREEN);
+            invalidate(DIAGNOSTICS);
+
+            // Auto Stop Timer Logic, for every zone
+            for (int z = 0; z < zoneCount; z++) {
+                ControllerData &zd = zoneState(z);
+                if (zd.isRunning && zd.testDuration > (uint32_t)timeSettingMinutes * 60) {
+                    zd.isRunning = false;
+                    sendZoneCommand(z, CMD_STOP_TEST);
+                    M5Dial.Speaker.tone(4000, 1000);
+                    if (z == activeZone) showScreen(MAIN_SCREEN);
+                }
             }
         }
     }
 
     if (showPasswordFail) {
         if (millis() - passwordFailTime > 1000) {
-            showPasswordFail = false; currentScreen = MAIN_SCREEN;
-            drawMainScreen();
+            showPasswordFail = false;
+            showScreen(MAIN_SCREEN);
         }
+        serviceFrame();
         delay(20); return;
     }
 
-    // Redraw Main Screen frequently for live updates
-    if (currentScreen == MAIN_SCREEN) drawMainScreen();
-
     long newPosition = M5Dial.Encoder.read();
     bool encoderMoved = abs(newPosition - oldPosition) >= 4;
     int encoderDir = (newPosition > oldPosition) ? 1 : -1;
 
     switch (currentScreen) {
         case MAIN_SCREEN:
+            if (encoderMoved && zoneCount > 1) {
+                selectZone((activeZone + encoderDir + zoneCount) % zoneCount);
+                oldPosition = newPosition;
+            }
             if (M5Dial.BtnA.wasPressed()) {
-                currentScreen = USER_MENU; userMenuSelection = 0;
+                userMenuSelection = 0;
                 userMenuItems[3] = data.isRunning ? "Stop Test" : "Start Test";
-                drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection);
+                showScreen(USER_MENU);
             }
             break;
 
@@ -169,27 +426,26 @@ void loop() {
             if (encoderMoved) {
                 userMenuSelection = constrain(userMenuSelection + encoderDir, 0, userMenuSize - 1);
                 oldPosition = newPosition;
-                drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection);
+                invalidate(USER_MENU);
             }
             if (M5Dial.BtnA.wasPressed()) {
                 String selection = userMenuItems[userMenuSelection];
-                if (selection == "Back") { currentScreen = MAIN_SCREEN; }
-                else if (selection == "Set Temperature") { currentScreen = SET_TEMP; drawValueEditor("Set Temperature", data.setpoint, "C", 0.5, 250.0); }
-                else if (selection == "Set Time") { currentScreen = SET_TIME; drawTimeEditor(); }
-                else if (selection == "Logging") { currentScreen = LOG_GRAPH; drawLogGraph(); }
+                if (selection == "Back") { showScreen(MAIN_SCREEN); }
+                else if (selection == "Set Temperature") { showScreen(SET_TEMP); }
+                else if (selection == "Set Time") { showScreen(SET_TIME); }
+                else if (selection == "Logging") { showScreen(LOG_GRAPH); }
                 else if (selection == "Service Menu") {
-                    enteredPassword = ""; passwordCharIndex = 0; currentScreen = SERVICE_MENU_LOGIN; drawPasswordScreen();
+                    enteredPassword = ""; passwordCharIndex = 0; showScreen(SERVICE_MENU_LOGIN);
                 }
                 else if (selection == "Run Test" || selection == "Stop Test") {
                     if (data.isRunning) {
                         data.isRunning = false;
-                        currentScreen = MAIN_SCREEN;
+                        sendCommand(CMD_STOP_TEST);
+                        showScreen(MAIN_SCREEN);
                     } else {
-                        currentScreen = CONFIRM_START_TEST;
                         confirmMenuSelection = 0;
-                        drawConfirmationScreen("Start Test?", "Yes", "No", confirmMenuSelection);
+                        showScreen(CONFIRM_START_TEST);
                     }
-                    sendToController();
                 }
                 oldPosition = M5Dial.Encoder.read();
             }
@@ -198,21 +454,21 @@ void loop() {
         case SERVICE_MENU_LOGIN:
             if (encoderMoved) {
                 passwordCharIndex = (passwordCharIndex + encoderDir + charsetSize) % charsetSize;
-                oldPosition = newPosition; drawPasswordScreen();
+                oldPosition = newPosition; invalidate(SERVICE_MENU_LOGIN);
             }
             if (M5Dial.BtnA.wasPressed()) {
                 enteredPassword += charset[passwordCharIndex];
                 if (enteredPassword.length() == 6) {
                     if (enteredPassword == correctPassword) {
-                        currentScreen = SERVICE_MENU; serviceMenuSelection = 0;
-                        drawRotaryMenu("Service Menu", serviceMenuItems, serviceMenuSize, serviceMenuSelection);
+                        serviceMenuSelection = 0;
+                        showScreen(SERVICE_MENU);
                     } else {
                         showPasswordFail = true; passwordFailTime = millis();
-                        drawMessageScreen("Password Incorrect", "", TFT_RED);
-                        return;
+                        invalidate(SERVICE_MENU_LOGIN);
+                        break;
                     }
                 }
-                drawPasswordScreen();
+                invalidate(SERVICE_MENU_LOGIN);
             }
             break;
 
@@ -220,15 +476,16 @@ void loop() {
             if (encoderMoved) {
                 serviceMenuSelection = constrain(serviceMenuSelection + encoderDir, 0, serviceMenuSize - 1);
                 oldPosition = newPosition;
-                drawRotaryMenu("Service Menu", serviceMenuItems, serviceMenuSize, serviceMenuSelection);
+                invalidate(SERVICE_MENU);
             }
             if (M5Dial.BtnA.wasPressed()) {
                 String sel = serviceMenuItems[serviceMenuSelection];
-                if (sel == "Back") { currentScreen = USER_MENU; drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection); }
+                if (sel == "Back") { showScreen(USER_MENU); }
                 else if (sel == "Set PID") {
-                    currentScreen = PID_SELECT_MENU; pidMenuSelection = 0;
-                    drawRotaryMenu("PID Config", pidMenuItems, pidMenuSize, pidMenuSelection);
+                    pidMenuSelection = 0;
+                    showScreen(PID_SELECT_MENU);
                 }
+                else if (sel == "Diagnostics") { showScreen(DIAGNOSTICS); }
             }
             break;
 
@@ -236,14 +493,14 @@ void loop() {
             if (encoderMoved) {
                 pidMenuSelection = constrain(pidMenuSelection + encoderDir, 0, pidMenuSize - 1);
                 oldPosition = newPosition;
-                drawRotaryMenu("PID Config", pidMenuItems, pidMenuSize, pidMenuSelection);
+                invalidate(PID_SELECT_MENU);
             }
             if (M5Dial.BtnA.wasPressed()) {
                 String sel = pidMenuItems[pidMenuSelection];
-                if (sel == "Back") { currentScreen = SERVICE_MENU; drawRotaryMenu("Service Menu", serviceMenuItems, serviceMenuSize, serviceMenuSelection); }
-                else if (sel == "Set Kp") { currentScreen = SET_KP; drawValueEditor("Set Kp", data.kp, "", 0.1, 200.0); }
-                else if (sel == "Set Ki") { currentScreen = SET_KI; drawValueEditor("Set Ki", data.ki, "", 0.01, 200.0); }
-                else if (sel == "Set Kd") { currentScreen = SET_KD; drawValueEditor("Set Kd", data.kd, "", 0.1, 200.0); }
+                if (sel == "Back") { showScreen(SERVICE_MENU); }
+                else if (sel == "Set Kp") { showScreen(SET_KP); }
+                else if (sel == "Set Ki") { showScreen(SET_KI); }
+                else if (sel == "Set Kd") { showScreen(SET_KD); }
             }
             break;
 
@@ -251,188 +508,872 @@ void loop() {
             if (encoderMoved) {
                 confirmMenuSelection = (confirmMenuSelection + encoderDir + 2) % 2;
                 oldPosition = newPosition;
-                drawConfirmationScreen("Start Test?", "Yes", "No", confirmMenuSelection);
+                invalidate(CONFIRM_START_TEST);
             }
             if (M5Dial.BtnA.wasPressed()) {
                 if (confirmMenuSelection == 0) { // YES selected
                     data.isRunning = 1; // Explicitly set to 1
-                    sendToController();
+                    sendCommand(CMD_START_TEST);
                 }
-                currentScreen = MAIN_SCREEN;
+                showScreen(MAIN_SCREEN);
             }
             break;
 
         case SET_TEMP:
         case SET_KP:
         case SET_KI:
-        case SET_KD:
+        case SET_KD: {
+            ValueEditor ed = editorFor(currentScreen, data);
             if (encoderMoved) {
-                float step = 0.5; float maxV = 250.0;
-                if(currentScreen == SET_KP || currentScreen == SET_KD) step = 0.1;
-                if(currentScreen == SET_KI) step = 0.01;
-
-                float *target;
-                const char* title;
-                if(currentScreen == SET_TEMP) { target = &data.setpoint; title = "Set Temperature"; }
-                else if(currentScreen == SET_KP) { target = &data.kp; title = "Set Kp"; }
-                else if(currentScreen == SET_KI) { target = &data.ki; title = "Set Ki"; }
-                else { target = &data.kd; title = "Set Kd"; }
-
-                *target += (step * encoderDir);
-                if (*target < 0) *target = 0;
-                if (*target > maxV) *target = maxV;
+                *ed.target += (ed.step * encoderDir);
+                if (*ed.target < 0) *ed.target = 0;
+                if (*ed.target > ed.maxVal) *ed.target = ed.maxVal;
 
                 oldPosition = newPosition;
-                drawValueEditor(title, *target, (currentScreen==SET_TEMP?"C":""), step, maxV);
+                invalidate(currentScreen);
             }
             if (M5Dial.BtnA.wasPressed()) {
-                sendToController();
-                if(currentScreen == SET_TEMP) { currentScreen = USER_MENU; drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection); }
-                else { currentScreen = PID_SELECT_MENU; drawRotaryMenu("PID Config", pidMenuItems, pidMenuSize, pidMenuSelection); }
+                if (currentScreen == SET_TEMP) sendCommand(CMD_SET_SETPOINT, data.setpoint);
+                else sendCommand(CMD_SET_GAINS, data.kp, data.ki, data.kd);
+                if(currentScreen == SET_TEMP) { showScreen(USER_MENU); }
+                else { showScreen(PID_SELECT_MENU); }
             }
             break;
+        }
 
         case SET_TIME:
             if (encoderMoved) {
                 timeSettingMinutes += 1 * encoderDir;
                 timeSettingMinutes = constrain(timeSettingMinutes, 0, (23 * 60 + 59));
-                oldPosition = newPosition; drawTimeEditor();
+                oldPosition = newPosition; invalidate(SET_TIME);
             }
             if (M5Dial.BtnA.wasPressed()) {
-                saveLocalSettings(); currentScreen = USER_MENU; drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection);
+                saveLocalSettings(); showScreen(USER_MENU);
             }
             break;
 
         case LOG_GRAPH:
              if (M5Dial.BtnA.wasPressed()) {
-                currentScreen = USER_MENU; drawRotaryMenu("User Menu", userMenuItems, userMenuSize, userMenuSelection);
+                showScreen(USER_MENU);
+            }
+            break;
+
+        case DIAGNOSTICS:
+            if (M5Dial.BtnA.wasPressed()) {
+                showScreen(SERVICE_MENU);
             }
             break;
     }
+
+    serviceFrame();
     delay(5);
 }
 
+// ================= FRAME SCHEDULER =================
+
+void invalidate(ScreenState screen) {
+    dirtyScreens |= (1 << screen);
+}
+
+void showScreen(ScreenState screen) {
+    currentScreen = screen;
+    invalidate(screen);
+}
+
+ValueEditor editorFor(ScreenState screen, ControllerData &d) {
+    ValueEditor ed = { "Set Temperature", &d.setpoint, "C", 0.5, 250.0 };
+    if (screen == SET_KP) { ed.title = "Set Kp"; ed.target = &d.kp; ed.unit = ""; ed.step = 0.1; }
+    else if (screen == SET_KI) { ed.title = "Set Ki"; ed.target = &d.ki; ed.unit = ""; ed.step = 0.01; }
+    else if (screen == SET_KD) { ed.title = "Set Kd"; ed.target = &d.kd; ed.unit = ""; ed.step = 0.1; }
+    return ed;
+}
+
+// Draws one strip of the screen in `view`; see renderRegion().
+void drawScreen(ScreenState screen) {
+    if (view.passwordFail) {
+        drawMessageScreen("Password Incorrect", "", TFT_RED);
+        return;
+    }
+    switch (screen) {
+        case MAIN_SCREEN: drawMainFields(); break;
+        case USER_MENU: drawRotaryMenu("User Menu", view.userMenu, userMenuSize, view.userMenuSelection); break;
+        case SERVICE_MENU: drawRotaryMenu("Service Menu", serviceMenuItems, serviceMenuSize, view.serviceMenuSelection); break;
+        case PID_SELECT_MENU: drawRotaryMenu("PID Config", pidMenuItems, pidMenuSize, view.pidMenuSelection); break;
+        case SERVICE_MENU_LOGIN: drawPasswordScreen(); break;
+        case CONFIRM_START_TEST: drawConfirmationScreen("Start Test?", "Yes", "No", view.confirmMenuSelection); break;
+        case SET_TIME: drawTimeEditor(); break;
+        case LOG_GRAPH: drawLogGraph(); break;
+        case DIAGNOSTICS: drawDiagnostics(); break;
+        case SET_TEMP:
+        case SET_KP:
+        case SET_KI:
+        case SET_KD: {
+            ValueEditor ed = editorFor(screen, view.data);
+            drawValueEditor(ed.title, *ed.target, ed.unit, ed.step, ed.maxVal);
+            break;
+        }
+    }
+}
+
+// Returns true while the screen is animating and wants another frame.
+bool renderScreen(ScreenState screen) {
+    if (view.passwordFail) {
+        renderRegion(0, 240, [screen] { drawScreen(screen); });
+        shownScreen = -1;
+        return false;
+    }
+    // Retained screens only push what changed while they stay on the panel
+    bool fresh = (shownScreen != screen);
+    bool more = false;
+    if (screen == USER_MENU) more = scrollMenu(fresh, view.userMenuSelection);
+    else if (screen == SERVICE_MENU) more = scrollMenu(fresh, view.serviceMenuSelection);
+    else if (screen == PID_SELECT_MENU) more = scrollMenu(fresh, view.pidMenuSelection);
+
+    if (screen == MAIN_SCREEN) drawMainScreen(fresh);
+    else if (screen == SERVICE_MENU_LOGIN) updatePasswordScreen(fresh);
+    else renderRegion(0, 240, [screen] { drawScreen(screen); });
+    shownScreen = screen;
+    return more;
+}
+
+// Spreads the n buckets a tier holds over the plot, oldest at the left
+// edge and newest at the right, and folds each column's share into one
+// min/max/mean (the mean of the means, the min of the mins, the max of the
+// maxes). Column c takes buckets [c * n / graphWidth, (c + 1) * n /
+// graphWidth), at least one, so drawing costs graphWidth columns however
+// many buckets there are, and a spike in any bucket still reaches its
+// column's max. Returns false if the tier is empty.
+bool decimateLog(const ZoneLog::Tier &tier, UiSnapshot &s) {
+    int n = tier.means.size();
+    if (n == 0) return false;
+    for (int c = 0; c < graphWidth; c++) {
+        int first = c * n / graphWidth;
+        int end = max(first + 1, (c + 1) * n / graphWidth);
+        float sum = 0, low = tier.lows[first], high = tier.highs[first];
+        for (int i = first; i < end; i++) {
+            sum += tier.means[i];
+            low = min(low, tier.lows[i]);
+            high = max(high, tier.highs[i]);
+        }
+        s.logMean[c] = sum / (end - first);
+        s.logLow[c] = low;
+        s.logHigh[c] = high;
+    }
+    s.logMin = tier.lows.min();
+    s.logMax = tier.highs.max();
+    return true;
+}
+
+// Loop side, once per pass: if anything was invalidated, snapshots the UI
+// state for the renderer and wakes it.
+void serviceFrame() {
+    if (dirtyScreens) {
+        UiSnapshot &s = uiMailbox.draft();
+        s.screen = currentScreen;
+        s.data = data;
+        s.i2cConnected = i2cConnected;
+        s.zone = activeZone;
+        s.zoneCount = zoneCount;
+        s.pollIntervalMs = i2cIntervalMs.load();
+        s.busPermille = i2cBusPermille.load();
+        s.badFrames = i2cBadFrames.load();
+        s.passwordFail = showPasswordFail;
+        s.timeSettingMinutes = timeSettingMinutes;
+        s.userMenuSelection = userMenuSelection;
+        s.serviceMenuSelection = serviceMenuSelection;
+        s.pidMenuSelection = pidMenuSelection;
+        s.confirmMenuSelection = confirmMenuSelection;
+        s.passwordCharIndex = passwordCharIndex;
+        s.passwordLength = enteredPassword.length();
+        memcpy(s.userMenu, userMenuItems, sizeof(s.userMenu));
+        s.logValid = logData[activeZone] && decimateLog(logData[activeZone]->tier(ZoneLog::tierFor(data.testDuration)), s);
+        uiMailbox.publish();
+
+        if (uiDirty.fetch_or(dirtyScreens) & dirtyScreens & (1 << currentScreen)) framesCoalesced++;
+        dirtyScreens = 0;
+#if UI_RENDER_CORE >= 0
+        if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+#endif
+    }
+#if UI_RENDER_CORE < 0
+    renderStep();
+#else
+    if (!renderTaskHandle) renderStep();
+#endif
+}
+
+// Render side: takes the newest snapshot and renders its screen if that
+// screen has been invalidated (or is animating) and the frame interval has
+// elapsed. Returns how many ms to wait before trying again, or renderIdle.
+const unsigned long renderIdle = (unsigned long)-1;
+
+unsigned long renderStep() {
+    uint32_t dirty = uiDirty.exchange(0);
+    if (uiMailbox.fetch()) view = uiMailbox.current();
+
+    uint16_t bit = (1 << view.screen);
+    if (pendingScreens & dirty & bit) framesCoalesced++;
+    pendingScreens |= dirty;
+    if (!(pendingScreens & bit)) return renderIdle;
+    unsigned long now = millis();
+    unsigned long interval = animating ? animFrameIntervalMs : frameIntervalMs;
+    if (now - lastFrame < interval) return interval - (now - lastFrame);
+    pendingScreens &= ~bit;
+    lastFrame = now;
+
+    unsigned long t0 = micros();
+    animating = renderScreen(view.screen);
+    lastFrameMicros = micros() - t0;
+    framesRendered++;
+    if (!animating) return renderIdle;
+    pendingScreens |= bit;
+    return animFrameIntervalMs;
+}
+
+#if UI_RENDER_CORE >= 0
+void renderTask(void *) {
+    initDisplayTransfer();
+    for (;;) {
+        unsigned long waitMs = renderStep();
+        ulTaskNotifyTake(pdTRUE, waitMs == renderIdle ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
+    }
+}
+#endif
+
 // ================= DRAWING =================
 // (Implementations below match your provided styles)
 
-void drawMainScreen() {
-    spr.fillSprite(TFT_BLACK);
-    spr.setTextDatum(TC_DATUM);
-    spr.setTextColor(TFT_WHITE, TFT_BLACK);
-    spr.loadFont(Noto);
+// --- BANDED RENDERER ---
+// There is no full-frame buffer: the sprite holds one 240 x bandRows strip.
+// Each draw* function is replayed once per strip with the sprite viewport
+// shifted to that strip, so it draws in screen coordinates and everything
+// outside the strip is clipped. drawText() and drawBigText() skip strings
+// that do not touch the strip at all, which keeps replays cheap.
+//
+// Finished strips are copied into one of two DMA buffers and sent with
+// pushImageDMA(), so the next strip is composed while the previous one is
+// still going out over SPI. pushImageDMA() waits for the transfer before it
+// to finish, so by the time a buffer comes round again it is free.
+int bandLeft = 0, bandTop = 0;          // area of the strip being composed
+int bandWidth = 240, bandHeight = 240;
+uint16_t *txBuf[2] = { nullptr, nullptr };
+int txNext = 0;
+
+void initDisplayTransfer() {
+    for (int i = 0; i < 2; i++) txBuf[i] = (uint16_t *)heap_caps_malloc(240 * bandRows * 2, MALLOC_CAP_DMA);
+    if (!txBuf[0] || !txBuf[1]) {
+        heap_caps_free(txBuf[0]); heap_caps_free(txBuf[1]);
+        txBuf[0] = txBuf[1] = nullptr;
+        return;     // pushStrip() falls back to blocking transfers
+    }
+    M5Dial.Display.startWrite();
+}
+
+// Sends the top-left w x rows pixels of the sprite to screen (x, y).
+void pushStrip(int x, int y, int w, int rows) {
+    const uint16_t *src = (uint16_t *)spr.getPointer();
+    if (!txBuf[0]) {
+        for (int r = 0; r < rows; r++) M5Dial.Display.pushImage(x, y + r, w, 1, src + r * 240);
+        return;
+    }
+    uint16_t *buf = txBuf[txNext];
+    txNext ^= 1;
+    for (int r = 0; r < rows; r++) memcpy(buf + r * w, src + r * 240, w * 2);
+    M5Dial.Display.pushImageDMA(x, y, w, rows, buf);
+}
+
+void beginBand(int x, int y, int w, int rows) {
+    bandLeft = x; bandTop = y;
+    bandWidth = w; bandHeight = rows;
+    spr.setViewport(-x, -y, x + w, y + rows, true);
+}
+
+void endBand() {
+    spr.resetViewport();
+    bandLeft = 0; bandTop = 0;
+    bandWidth = 240; bandHeight = 240;
+}
+
+bool bandHit(int top, int height) {
+    return top < bandTop + bandHeight && top + height > bandTop;
+}
+
+bool rectHit(int x, int y, int w, int h) {
+    return bandHit(y, h) && x < bandLeft + bandWidth && x + w > bandLeft;
+}
+
+// Top row of a string drawn at y with the given datum and line height.
+// Datums are laid out left/centre/right by top/middle/bottom.
+int datumTop(int y, uint8_t datum, int height) {
+    if (datum / 3 == 1) return y - height / 2;
+    if (datum / 3 == 2) return y - height;
+    return y;
+}
+
+void drawText(const char *text, int x, int y) {
+    int h = spr.fontHeight();
+    if (!bandHit(datumTop(y, spr.getTextDatum(), h), h)) return;
+    spr.drawString(text, x, y);
+}
 
-    if (!i2cConnected) {
-        spr.setTextColor(TFT_RED, TFT_BLACK);
-        spr.drawString("NO CONNECT", 120, 5);
+// Composes and pushes the screen rectangle (x, y, w, h) strip by strip.
+template <typename Draw>
+void renderRect(int x, int y, int w, int h, Draw draw) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    w = min(w, 240 - x);
+    h = min(h, 240 - y);
+    for (int top = y; top < y + h; top += bandRows) {
+        int rows = min(bandRows, y + h - top);
+        beginBand(x, top, w, rows);
+        draw();
+        endBand();
+        pushStrip(x, top, w, rows);
+    }
+}
+
+template <typename Draw>
+void renderRegion(int top, int height, Draw draw) {
+    renderRect(0, top, 240, height, draw);
+}
+
+// --- FONT CACHE ---
+// spr.loadFont() re-parses the VLW header and allocates the glyph metric
+// tables on every call. Each font is parsed once at boot instead and
+// useFont() swaps its resident tables into the sprite by pointer.
+// Do not call spr.loadFont()/unloadFont() directly while a cached font is
+// active: they would free the cached tables.
+enum FontId : uint8_t { FONT_NONE, FONT_NOTO, FONT_BIG, FONT_SMALL, FONT_COUNT };
+
+struct FontHandle {
+    TFT_eSPI::fontMetrics metrics;
+    uint16_t *unicode;
+    uint8_t *height;
+    uint8_t *width;
+    uint8_t *xAdvance;
+    int16_t *dY;
+    int8_t *dX;
+    uint32_t *bitmap;
+};
+FontHandle fonts[FONT_COUNT];
+FontId activeFont = FONT_NONE;
+
+void selectFontTables(const FontHandle &f, bool loaded) {
+    spr.gFont = f.metrics;
+    spr.gUnicode = f.unicode;
+    spr.gHeight = f.height;
+    spr.gWidth = f.width;
+    spr.gxAdvance = f.xAdvance;
+    spr.gdY = f.dY;
+    spr.gdX = f.dX;
+    spr.gBitmap = f.bitmap;
+    spr.fontLoaded = loaded;
+}
+
+void cacheFont(FontId id, const uint8_t *array) {
+    useFont(FONT_NONE);
+    spr.loadFont(array);
+    FontHandle &f = fonts[id];
+    f.metrics = spr.gFont;
+    f.unicode = spr.gUnicode;
+    f.height = spr.gHeight;
+    f.width = spr.gWidth;
+    f.xAdvance = spr.gxAdvance;
+    f.dY = spr.gdY;
+    f.dX = spr.gdX;
+    f.bitmap = spr.gBitmap;
+    activeFont = id;
+}
+
+void cacheFonts() {
+    memset(fonts, 0, sizeof(fonts));
+    cacheFont(FONT_NOTO, Noto);
+    cacheFont(FONT_BIG, bigFont);
+    cacheFont(FONT_SMALL, smallFont);
+    useFont(FONT_NONE);
+}
+
+void useFont(FontId id) {
+    if (id == activeFont) return;
+    activeFont = id;
+    selectFontTables(fonts[id], id != FONT_NONE);
+}
+
+#ifdef UI_BENCHMARK
+// Renders the main screen's text the old way (loadFont/unloadFont around
+// every string) and with cached handles, and prints the per-frame cost.
+unsigned long benchmarkFontFrame(bool cached) {
+    const uint8_t *arrays[] = { Noto, bigFont, bigFont, Noto, Noto };
+    const FontId ids[] = { FONT_NOTO, FONT_BIG, FONT_BIG, FONT_NOTO, FONT_NOTO };
+    const char *text[] = { "Set: 100.0 C", "123.4 C", "00:29:59", "Status: Running", "Click to Open Menu" };
+    const int ys[] = { 20, 80, 135, 200, 220 };
+
+    unsigned long t0 = micros();
+    for (int y = 0; y < 240; y += bandRows) {
+        beginBand(0, y, 240, bandRows);
+        spr.fillSprite(TFT_BLACK);
+        spr.setTextDatum(MC_DATUM);
         spr.setTextColor(TFT_WHITE, TFT_BLACK);
+        for (int i = 0; i < 5; i++) {
+            if (cached) useFont(ids[i]);
+            else spr.loadFont(arrays[i]);
+            drawText(text[i], 120, ys[i]);
+            if (!cached) spr.unloadFont();
+        }
+        endBand();
+    }
+    return micros() - t0;
+}
+
+void benchmarkFontCache() {
+    const int frames = 50;
+    unsigned long reload = 0, cached = 0;
+    useFont(FONT_NONE);
+    for (int i = 0; i < frames; i++) reload += benchmarkFontFrame(false);
+    for (int i = 0; i < frames; i++) cached += benchmarkFontFrame(true);
+    useFont(FONT_NONE);
+    Serial.printf("font bench: loadFont per string %lu us/frame, cached %lu us/frame\n",
+                  reload / frames, cached / frames);
+}
+#endif
+
+// --- BIG DIGIT ATLAS ---
+// The bigFont readouts only ever use these characters. Their coverage maps
+// are copied out of the font once at boot and expanded through a per-colour
+// lookup table pre-blended against the background, so a readout is a few
+// rectangular blits instead of TFT_eSPI's per-pixel alpha blending path.
+const char atlasChars[] = "0123456789.:C- ";
+const int atlasCount = sizeof(atlasChars) - 1;
+
+struct AtlasGlyph {
+    uint8_t w, h, xAdvance;
+    int8_t dX;
+    int16_t dY;
+    uint16_t offset;    // into atlasCoverage
+};
+AtlasGlyph atlasGlyphs[atlasCount];
+uint8_t *atlasCoverage = nullptr;
+uint16_t *atlasScratch = nullptr;   // one glyph expanded to RGB565
+int atlasAscent = 0, atlasHeight = 0, atlasSpace = 0;
+
+struct AtlasPalette {
+    uint16_t fg, bg;
+    uint16_t lut[256];              // coverage -> blended colour, sprite byte order
+};
+const int atlasPaletteCount = 8;
+AtlasPalette atlasPalettes[atlasPaletteCount];
+int atlasPalettesUsed = 0;
+
+const uint16_t *atlasPalette(uint16_t fg, uint16_t bg) {
+    for (int i = 0; i < atlasPalettesUsed; i++) {
+        if (atlasPalettes[i].fg == fg && atlasPalettes[i].bg == bg) return atlasPalettes[i].lut;
+    }
+    int slot = atlasPalettesUsed < atlasPaletteCount ? atlasPalettesUsed++ : atlasPaletteCount - 1;
+    AtlasPalette &p = atlasPalettes[slot];
+    p.fg = fg; p.bg = bg;
+    for (int a = 0; a < 256; a++) {
+        uint16_t c = spr.alphaBlend(a, fg, bg);
+        p.lut[a] = (c >> 8) | (c << 8);
+    }
+    return p.lut;
+}
+
+void buildBigAtlas() {
+    useFont(FONT_BIG);
+    atlasAscent = spr.gFont.maxAscent;
+    atlasHeight = spr.gFont.yAdvance;
+    atlasSpace = spr.gFont.spaceWidth;
+
+    size_t total = 0, largest = 0;
+    for (int i = 0; i < atlasCount; i++) {
+        AtlasGlyph &g = atlasGlyphs[i];
+        uint16_t gNum;
+        memset(&g, 0, sizeof(g));
+        if (atlasChars[i] == ' ' || !spr.getUnicodeIndex(atlasChars[i], &gNum)) continue;
+        g.w = spr.gWidth[gNum]; g.h = spr.gHeight[gNum];
+        g.xAdvance = spr.gxAdvance[gNum];
+        g.dX = spr.gdX[gNum]; g.dY = spr.gdY[gNum];
+        g.offset = total;
+        total += g.w * g.h;
+        if ((size_t)g.w * g.h > largest) largest = g.w * g.h;
+    }
+
+    atlasCoverage = (uint8_t *)malloc(total);
+    atlasScratch = (uint16_t *)malloc(largest * 2);
+    if (!atlasCoverage || !atlasScratch) {
+        free(atlasCoverage); free(atlasScratch);
+        atlasCoverage = nullptr; atlasScratch = nullptr;
+        return;     // drawBigText() falls back to the font renderer
+    }
+    for (int i = 0; i < atlasCount; i++) {
+        uint16_t gNum;
+        if (atlasGlyphs[i].w == 0 || !spr.getUnicodeIndex(atlasChars[i], &gNum)) continue;
+        memcpy(atlasCoverage + atlasGlyphs[i].offset, spr.gFont.gArray + spr.gBitmap[gNum],
+               atlasGlyphs[i].w * atlasGlyphs[i].h);
+    }
+
+    atlasPalette(TFT_WHITE, TFT_BLACK);
+    atlasPalette(TFT_GREEN, TFT_BLACK);
+    atlasPalette(TFT_ORANGE, TFT_BLACK);
+}
+
+// Draws text with the same placement as spr.drawString() with bigFont loaded.
+// Returns false (drawing nothing) if a character is not in the atlas.
+bool drawBigText(const char *text, int x, int y, uint8_t datum, uint16_t fg, uint16_t bg) {
+    if (!atlasCoverage) return false;
+    int idx[24];
+    int n = 0;
+    for (const char *c = text; *c; c++) {
+        const char *hit = strchr(atlasChars, *c);
+        if (!hit || n == 24) return false;
+        idx[n++] = hit - atlasChars;
+    }
+
+    // Width as textWidth() computes it: the last glyph counts its ink, not its advance
+    int width = 0;
+    for (int i = 0; i < n; i++) {
+        const AtlasGlyph &g = atlasGlyphs[idx[i]];
+        if (g.w == 0) width += atlasSpace + 1;
+        else if (i == n - 1) width += g.dX + g.w;
+        else width += g.xAdvance;
+    }
+    if (datum % 3 == 1) x -= width / 2;
+    else if (datum % 3 == 2) x -= width;
+    y = datumTop(y, datum, atlasHeight);
+    if (!bandHit(y, atlasHeight)) return true;
+
+    const uint16_t *lut = atlasPalette(fg, bg);
+    for (int i = 0; i < n; i++) {
+        const AtlasGlyph &g = atlasGlyphs[idx[i]];
+        if (g.w == 0) { x += atlasSpace; continue; }
+        const uint8_t *cov = atlasCoverage + g.offset;
+        int count = g.w * g.h;
+        for (int p = 0; p < count; p++) atlasScratch[p] = lut[cov[p]];
+        spr.pushImage(x + g.dX, y + atlasAscent - g.dY, g.w, g.h, atlasScratch);
+        x += g.xAdvance;
+    }
+    return true;
+}
+
+// --- MAIN SCREEN (retained) ---
+// The main screen remembers what each field last put on the panel and only
+// re-renders and pushes the rows of the fields whose text or colour changed.
+enum MainField { FIELD_HEADER, FIELD_TEMP, FIELD_TIMER, FIELD_STATUS, FIELD_HINT, MAIN_FIELD_COUNT };
+
+struct FieldContent {
+    char text[24];
+    uint16_t color;
+    int16_t y;
+};
+
+// Rows owned by each field. They cover the ink of the fonts drawn at the
+// positions below and never overlap, so a field can be cleared on its own.
+struct FieldBand { int16_t top, height; };
+const FieldBand mainBands[MAIN_FIELD_COUNT] = {
+    {   0, 44 },  // "Set: ..." / "NO CONNECT"
+    {  56, 62 },  // temperature (bigFont)
+    { 118, 58 },  // timer (bigFont)
+    { 178, 24 },  // status line
+    { 202, 24 },  // menu hint
+};
+
+FieldContent mainShown[MAIN_FIELD_COUNT];
+
+void composeMainScreen(FieldContent f[]) {
+    memset(f, 0, sizeof(FieldContent) * MAIN_FIELD_COUNT);
+
+    // "Z2 " in front if there are several zones, then the header itself
+    char *header = f[FIELD_HEADER].text;
+    size_t headerSize = sizeof(f[FIELD_HEADER].text);
+    int prefix = view.zoneCount > 1 ? snprintf(header, headerSize, "Z%d ", view.zone + 1) : 0;
+    if (!view.i2cConnected) {
+        snprintf(header + prefix, headerSize - prefix, "NO CONNECT");
+        f[FIELD_HEADER].color = TFT_RED;
+        f[FIELD_HEADER].y = 5;
     } else {
-        char setpointBuf[32];
-        sprintf(setpointBuf, "Set: %.1f C", data.setpoint);
-        spr.drawString(setpointBuf, 120, 20);
+        snprintf(header + prefix, headerSize - prefix, "Set: %.1f C", view.data.setpoint);
+        f[FIELD_HEADER].color = TFT_WHITE;
+        f[FIELD_HEADER].y = 20;
     }
 
-    spr.setTextDatum(MC_DATUM);
-    if (data.isRunning) {
-        if (abs(data.currentTemp - data.setpoint) > 2.0) spr.setTextColor(TFT_ORANGE, TFT_BLACK);
-        else spr.setTextColor(TFT_GREEN, TFT_BLACK);
-    } else spr.setTextColor(TFT_WHITE, TFT_BLACK);
-
-    spr.loadFont(bigFont);
-    char tempBuf[16];
-    sprintf(tempBuf, "%.1f C", data.currentTemp);
-    spr.drawString(tempBuf, 120, 80);
-
-    char timeBuf[32];
-    if (data.isRunning) {
-        long totalSeconds = (long)timeSettingMinutes * 60;
-        long remaining = totalSeconds - data.testDuration;
+    if (view.data.isRunning) {
+        if (abs(view.data.currentTemp - view.data.setpoint) > 2.0) f[FIELD_TEMP].color = TFT_ORANGE;
+        else f[FIELD_TEMP].color = TFT_GREEN;
+    } else f[FIELD_TEMP].color = TFT_WHITE;
+    snprintf(f[FIELD_TEMP].text, sizeof(f[FIELD_TEMP].text), "%.1f C", view.data.currentTemp);
+    f[FIELD_TEMP].y = 80;
+
+    if (view.data.isRunning) {
+        long totalSeconds = (long)view.timeSettingMinutes * 60;
+        long remaining = totalSeconds - view.data.testDuration;
         if (remaining < 0) remaining = 0;
         int hours = remaining / 3600;
         int mins = (remaining / 60) % 60;
         int secs = remaining % 60;
-        sprintf(timeBuf, "%02d:%02d:%02d", hours, mins, secs);
-        spr.setTextColor(TFT_GREEN, TFT_BLACK);
+        snprintf(f[FIELD_TIMER].text, sizeof(f[FIELD_TIMER].text), "%02d:%02d:%02d", hours, mins, secs);
+        f[FIELD_TIMER].color = TFT_GREEN;
     } else {
-        int hours = timeSettingMinutes / 60;
-        int minutes = timeSettingMinutes % 60;
-        sprintf(timeBuf, "%02d:%02d:00", hours, minutes);
-        spr.setTextColor(TFT_WHITE, TFT_BLACK);
+        int hours = view.timeSettingMinutes / 60;
+        int minutes = view.timeSettingMinutes % 60;
+        snprintf(f[FIELD_TIMER].text, sizeof(f[FIELD_TIMER].text), "%02d:%02d:00", hours, minutes);
+        f[FIELD_TIMER].color = TFT_WHITE;
     }
-    spr.drawString(timeBuf, 120, 135);
-    spr.unloadFont();
-
-    spr.setTextDatum(BC_DATUM);
-    spr.loadFont(Noto);
-    char statusBuf[32];
-    if (data.errorState != 0) {
-        spr.setTextColor(TFT_RED, TFT_BLACK);
-        if(data.errorState == 1) strcpy(statusBuf, "ERR: SENSOR");
-        else if(data.errorState == 2) strcpy(statusBuf, "ERR: OVERTEMP");
-        else if(data.errorState == 3) strcpy(statusBuf, "ERR: USB LOST");
-    } else if (data.isRunning) {
-        strcpy(statusBuf, "Status: Running");
-        spr.setTextColor(TFT_GREEN, TFT_BLACK);
+    f[FIELD_TIMER].y = 135;
+
+    if (view.data.errorState != 0) {
+        f[FIELD_STATUS].color = TFT_RED;
+        if(view.data.errorState == 1) strcpy(f[FIELD_STATUS].text, "ERR: SENSOR");
+        else if(view.data.errorState == 2) strcpy(f[FIELD_STATUS].text, "ERR: OVERTEMP");
+        else if(view.data.errorState == 3) strcpy(f[FIELD_STATUS].text, "ERR: USB LOST");
+        else snprintf(f[FIELD_STATUS].text, sizeof(f[FIELD_STATUS].text), "ERR: %d", view.data.errorState);
+    } else if (view.data.isRunning) {
+        strcpy(f[FIELD_STATUS].text, "Status: Running");
+        f[FIELD_STATUS].color = TFT_GREEN;
     } else {
-        strcpy(statusBuf, "Status: Idle");
-        spr.setTextColor(TFT_WHITE, TFT_BLACK);
+        strcpy(f[FIELD_STATUS].text, "Status: Idle");
+        f[FIELD_STATUS].color = TFT_WHITE;
     }
-    spr.drawString(statusBuf, 120, 200);
-    spr.setTextColor(grays[8], TFT_BLACK);
-    spr.drawString("Click to Open Menu", 120, 220);
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    f[FIELD_STATUS].y = 200;
+
+    strcpy(f[FIELD_HINT].text, "Click to Open Menu");
+    f[FIELD_HINT].color = grays[8];
+    f[FIELD_HINT].y = 220;
+}
+
+bool fieldChanged(const FieldContent &a, const FieldContent &b) {
+    return a.color != b.color || a.y != b.y || strcmp(a.text, b.text) != 0;
+}
+
+void drawMainField(int field, const FieldContent &c) {
+    bool big = (field == FIELD_TEMP || field == FIELD_TIMER);
+    if (big && drawBigText(c.text, 120, c.y, MC_DATUM, c.color, TFT_BLACK)) return;
+    useFont(big ? FONT_BIG : FONT_NOTO);
+    if (field == FIELD_HEADER) spr.setTextDatum(TC_DATUM);
+    else if (big) spr.setTextDatum(MC_DATUM);
+    else spr.setTextDatum(BC_DATUM);
+    spr.setTextColor(c.color, TFT_BLACK);
+    drawText(c.text, 120, c.y);
 }
 
-void drawRotaryMenu(const char *title, String items[], int numItems, int selection) {
+void drawMainFields() {
     spr.fillSprite(TFT_BLACK);
-    spr.loadFont(Noto);
+    for (int i = 0; i < MAIN_FIELD_COUNT; i++) {
+        if (bandHit(mainBands[i].top, mainBands[i].height)) drawMainField(i, mainShown[i]);
+    }
+}
+
+void drawMainScreen(bool fresh) {
+    FieldContent next[MAIN_FIELD_COUNT];
+    composeMainScreen(next);
+
+    if (fresh) {
+        memcpy(mainShown, next, sizeof(mainShown));
+        renderRegion(0, 240, drawMainFields);
+        return;
+    }
+
+    for (int i = 0; i < MAIN_FIELD_COUNT; i++) {
+        if (!fieldChanged(next[i], mainShown[i])) continue;
+        mainShown[i] = next[i];
+        renderRegion(mainBands[i].top, mainBands[i].height, drawMainFields);
+    }
+}
+
+// --- ROTARY MENU ---
+// The selected item sits in the highlight at the centre and the list scrolls
+// past it. Each item string is rasterized once into a coverage bitmap from
+// the cached Noto tables; a frame is then just the highlight box plus rows of
+// those bitmaps expanded through colour tables, so a scroll step can be
+// animated over several frames without going through the font renderer.
+const int menuCenterY = 120;
+const int menuSpacing = 40;
+const int menuHighlightTop = menuCenterY - 18, menuHighlightHeight = 36;
+const int menuTop = menuCenterY - 2 * menuSpacing - 8;       // rows the list may use
+const int menuBottom = menuCenterY + 2 * menuSpacing + 8;
+const unsigned long menuScrollMs = 120;
+
+struct MenuItemBitmap {
+    const char *text;           // the item string itself is the cache key
+    int16_t left, top;          // ink box relative to the drawString() origin
+    int16_t width, height;
+    int16_t textWidth;
+    uint8_t *coverage;
+};
+const int menuCacheSize = 16;
+MenuItemBitmap menuCache[menuCacheSize];
+int menuCacheUsed = 0;
+
+// Render side scroll state of the menu on screen.
+int menuSelection = 0;
+int menuScroll = 0;             // current list offset in pixels
+int menuScrollFrom = 0;         // offset when the current scroll started, 0 at rest
+unsigned long menuScrollStart = 0;
+
+// Returns the cached bitmap of an item, rasterizing it on first use, or
+// nullptr if the cache is full.
+const MenuItemBitmap *menuItemBitmap(const char *text) {
+    for (int i = 0; i < menuCacheUsed; i++) {
+        if (menuCache[i].text == text) return &menuCache[i];
+    }
+    if (menuCacheUsed == menuCacheSize) return nullptr;
+
+    useFont(FONT_NOTO);
+    int left = 0, right = 0, top = 0, bottom = 0, cursor = 0;
+    uint16_t gNum;
+    for (const char *c = text; *c; c++) {
+        if (!spr.getUnicodeIndex(*c, &gNum)) { cursor += spr.gFont.spaceWidth; continue; }
+        int x0 = cursor + spr.gdX[gNum];
+        int y0 = spr.gFont.maxAscent - spr.gdY[gNum];
+        left = min(left, x0); right = max(right, x0 + spr.gWidth[gNum]);
+        top = min(top, y0); bottom = max(bottom, y0 + spr.gHeight[gNum]);
+        cursor += spr.gxAdvance[gNum];
+    }
+
+    MenuItemBitmap &b = menuCache[menuCacheUsed];
+    b.coverage = (uint8_t *)calloc((right - left) * (bottom - top), 1);
+    if (!b.coverage) return nullptr;
+    b.text = text;
+    b.left = left; b.top = top;
+    b.width = right - left; b.height = bottom - top;
+    b.textWidth = spr.textWidth(text);
+
+    // Later glyphs overwrite earlier ones where they overlap, as drawString() does
+    cursor = 0;
+    for (const char *c = text; *c; c++) {
+        if (!spr.getUnicodeIndex(*c, &gNum)) { cursor += spr.gFont.spaceWidth; continue; }
+        const uint8_t *src = spr.gFont.gArray + spr.gBitmap[gNum];
+        int x0 = cursor + spr.gdX[gNum] - left;
+        int y0 = spr.gFont.maxAscent - spr.gdY[gNum] - top;
+        for (int y = 0; y < spr.gHeight[gNum]; y++) {
+            uint8_t *dst = b.coverage + (y0 + y) * b.width + x0;
+            for (int x = 0; x < spr.gWidth[gNum]; x++, src++) {
+                if (*src) dst[x] = *src;
+            }
+        }
+        cursor += spr.gxAdvance[gNum];
+    }
+    menuCacheUsed++;
+    return &b;
+}
+
+// Moves the list towards `selection`. A new selection starts a scroll from
+// wherever the list is now; returns true while the list is still moving.
+bool scrollMenu(bool fresh, int selection) {
+    unsigned long now = millis();
+    if (fresh) {
+        menuScrollFrom = 0;
+    } else if (selection != menuSelection) {
+        menuScrollFrom = constrain(menuScroll + (selection - menuSelection) * menuSpacing,
+                                   -2 * menuSpacing, 2 * menuSpacing);
+        menuScrollStart = now;
+    }
+    menuSelection = selection;
+
+    unsigned long t = now - menuScrollStart;
+    if (menuScrollFrom == 0 || t >= menuScrollMs) {
+        menuScrollFrom = 0;
+        menuScroll = 0;
+        return false;
+    }
+    float left = 1.0f - (float)t / menuScrollMs;     // ease out
+    menuScroll = menuScrollFrom * left * left;
+    return menuScroll != 0;
+}
+
+// Colour of item text whose centre is at row y.
+uint16_t menuTextColor(int y) {
+    int slot = (abs(y - menuCenterY) + menuSpacing / 2) / menuSpacing;
+    return slot <= 1 ? grays[5] : grays[9];
+}
+
+// Draws an item centred on (120, y). Rows inside the highlight are drawn
+// black on white, the rest in the grey of the nearest slot; rows outside the
+// list window are left alone so items slide in and out under the title.
+void drawMenuItem(const char *text, int y) {
+    const MenuItemBitmap *b = menuItemBitmap(text);
+    if (!b) {
+        if (abs(y - menuCenterY) > 2 * menuSpacing) return;
+        bool selected = abs(y - menuCenterY) < menuSpacing / 2;
+        spr.setTextColor(selected ? TFT_BLACK : menuTextColor(y), selected ? TFT_WHITE : TFT_BLACK);
+        drawText(text, 120, y);
+        return;
+    }
+
+    int x0 = 120 - b->textWidth / 2 + b->left;
+    int y0 = y - spr.fontHeight() / 2 + b->top;
+    int rowStart = max(max(y0, menuTop), bandTop);
+    int rowEnd = min(min(y0 + b->height, menuBottom), bandTop + bandHeight);
+    int colStart = max(x0, bandLeft);
+    int colEnd = min(x0 + b->width, bandLeft + bandWidth);
+    if (rowStart >= rowEnd || colStart >= colEnd) return;
+
+    const uint16_t *inside = atlasPalette(TFT_BLACK, TFT_WHITE);
+    const uint16_t *outside = atlasPalette(menuTextColor(y), TFT_BLACK);
+    uint16_t *pixels = (uint16_t *)spr.getPointer();
+    for (int row = rowStart; row < rowEnd; row++) {
+        bool lit = row >= menuHighlightTop && row < menuHighlightTop + menuHighlightHeight;
+        const uint16_t *lut = lit ? inside : outside;
+        const uint8_t *cov = b->coverage + (row - y0) * b->width - x0;
+        uint16_t *dst = pixels + (row - bandTop) * 240 - bandLeft;
+        for (int col = colStart; col < colEnd; col++) {
+            if (cov[col]) dst[col] = lut[cov[col]];
+        }
+    }
+}
+
+void drawRotaryMenu(const char *title, const char *items[], int numItems, int selection) {
+    spr.fillSprite(TFT_BLACK);
+    useFont(FONT_NOTO);
     spr.setTextColor(TFT_WHITE, TFT_BLACK);
     spr.setTextDatum(TC_DATUM);
-    spr.drawString(title, 120, 20);
-    int centerY = 120;
-    int itemSpacing = 40;
-    for (int i = -2; i <= 2; i++) {
+    drawText(title, 120, 20);
+    spr.fillRoundRect(10, menuHighlightTop, 220, menuHighlightHeight, 5, TFT_WHITE);
+    spr.setTextDatum(MC_DATUM);
+    for (int i = -4; i <= 4; i++) {
         int itemIndex = selection + i;
         if (itemIndex >= 0 && itemIndex < numItems) {
-            int yPos = centerY + (i * itemSpacing);
-            if (i == 0) {
-                spr.fillRoundRect(10, yPos - 18, 220, 36, 5, TFT_WHITE);
-                spr.setTextColor(TFT_BLACK, TFT_WHITE);
-            } else {
-                if (abs(i) == 1) spr.setTextColor(grays[5], TFT_BLACK);
-                else spr.setTextColor(grays[9], TFT_BLACK);
-            }
-            spr.setTextDatum(MC_DATUM);
-            spr.drawString(items[itemIndex], 120, yPos);
+            drawMenuItem(items[itemIndex], menuCenterY + i * menuSpacing + menuScroll);
         }
     }
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
 }
 
+// Character positions on the ring: 120 + 105 * (cos, sin) of
+// i / charsetSize * 2 * PI - PI / 2, computed in float and truncated as the
+// old per-frame code did (hence 119 rather than 120 at the poles).
+const int16_t passwordRing[charsetSize][2] = {
+    {119,  15}, {138,  16}, {155,  21}, {172,  29}, {187,  39}, {200,  52},
+    {210,  67}, {218,  84}, {223, 101}, {225, 120}, {223, 138}, {218, 155},
+    {210, 172}, {200, 187}, {187, 200}, {172, 210}, {155, 218}, {138, 223},
+    {119, 224}, {101, 223}, { 84, 218}, { 67, 210}, { 52, 200}, { 39, 187},
+    { 29, 172}, { 21, 155}, { 16, 138}, { 15, 119}, { 16, 101}, { 21,  84},
+    { 29,  67}, { 39,  52}, { 52,  39}, { 67,  29}, { 84,  21}, {101,  16},
+};
+const int ringCell = 32;    // square around a ring position holding its highlight and glyph
+
 void drawPasswordScreen() {
     spr.fillSprite(TFT_BLACK);
-    spr.loadFont(Noto);
+    useFont(FONT_NOTO);
     spr.setTextDatum(MC_DATUM);
-    int radius = 105;
+    char glyph[2] = { 0, 0 };
     for (int i = 0; i < charsetSize; i++) {
-        float angle = (float)i / charsetSize * 2.0 * PI - (PI / 2.0);
-        int x = 120 + radius * cos(angle);
-        int y = 120 + radius * sin(angle);
-        if (i == passwordCharIndex) {
+        int x = passwordRing[i][0];
+        int y = passwordRing[i][1];
+        if (!rectHit(x - ringCell / 2, y - ringCell / 2, ringCell, ringCell)) continue;
+        glyph[0] = charset[i];
+        if (i == view.passwordCharIndex) {
             spr.fillCircle(x, y, 15, TFT_WHITE);
             spr.setTextColor(TFT_BLACK, TFT_WHITE);
             spr.setTextSize(2);
-            spr.drawString(String(charset[i]), x, y);
+            drawText(glyph, x, y);
             spr.setTextSize(1);
         } else {
             spr.setTextColor(TFT_WHITE, TFT_BLACK);
-            spr.drawString(String(charset[i]), x, y);
+            drawText(glyph, x, y);
         }
     }
     spr.setTextDatum(TC_DATUM);
     spr.setTextColor(TFT_WHITE, TFT_BLACK);
-    spr.drawString("Enter Password", 120, 70);
+    drawText("Enter Password", 120, 70);
     int numChars = 6;
     int blockHeight = 40; int totalWidth = 180;
     int charSlotWidth = totalWidth / numChars;
@@ -443,33 +1384,50 @@ void drawPasswordScreen() {
         spr.drawLine(lineX, startY, lineX, startY + blockHeight, TFT_WHITE);
     }
     spr.setTextDatum(MC_DATUM);
-    for (int i = 0; i < enteredPassword.length(); i++) {
+    for (int i = 0; i < view.passwordLength; i++) {
         int charX = startX + (i * charSlotWidth) + (charSlotWidth / 2);
         int charY = startY + (blockHeight / 2);
         spr.setTextColor(TFT_GREEN, TFT_BLACK);
-        spr.drawString("X", charX, charY);
+        drawText("X", charX, charY);
+    }
+}
+
+// The panel keeps the last frame, so turning the encoder only repaints the
+// cells of the old and new highlighted characters. A new character in the
+// entry box or coming back from another screen repaints everything.
+void renderRingCell(int index) {
+    int x = passwordRing[index][0] - ringCell / 2;
+    int y = passwordRing[index][1] - ringCell / 2;
+    renderRect(x, y, ringCell, ringCell, drawPasswordScreen);
+}
+
+void updatePasswordScreen(bool fresh) {
+    static int shownIndex = -1, shownLength = -1;
+    if (fresh || view.passwordLength != shownLength) {
+        renderRegion(0, 240, drawPasswordScreen);
+    } else if (view.passwordCharIndex != shownIndex) {
+        renderRingCell(shownIndex);
+        renderRingCell(view.passwordCharIndex);
     }
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    shownIndex = view.passwordCharIndex;
+    shownLength = view.passwordLength;
 }
 
 void drawMessageScreen(const char* msg1, const char* msg2, uint16_t color) {
     spr.fillSprite(TFT_BLACK);
-    spr.loadFont(Noto);
+    useFont(FONT_NOTO);
     spr.setTextDatum(MC_DATUM);
     spr.setTextColor(color, TFT_BLACK);
-    spr.drawString(msg1, 120, 110);
-    spr.drawString(msg2, 120, 140);
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    drawText(msg1, 120, 110);
+    drawText(msg2, 120, 140);
 }
 
 void drawConfirmationScreen(const char* title, const char* option1, const char* option2, int selection) {
     spr.fillSprite(TFT_BLACK);
-    spr.loadFont(Noto);
+    useFont(FONT_NOTO);
     spr.setTextColor(TFT_WHITE, TFT_BLACK);
     spr.setTextDatum(TC_DATUM);
-    spr.drawString(title, 120, 60);
+    drawText(title, 120, 60);
     if (selection == 0) {
         spr.fillRoundRect(30, 110, 80, 40, 5, TFT_WHITE);
         spr.setTextColor(TFT_BLACK, TFT_WHITE);
@@ -478,7 +1436,7 @@ void drawConfirmationScreen(const char* title, const char* option1, const char*
         spr.setTextColor(TFT_WHITE, TFT_BLACK);
     }
     spr.setTextDatum(MC_DATUM);
-    spr.drawString(option1, 70, 130);
+    drawText(option1, 70, 130);
     if (selection == 1) {
         spr.fillRoundRect(130, 110, 80, 40, 5, TFT_WHITE);
         spr.setTextColor(TFT_BLACK, TFT_WHITE);
@@ -487,80 +1445,138 @@ void drawConfirmationScreen(const char* title, const char* option1, const char*
         spr.setTextColor(TFT_WHITE, TFT_BLACK);
     }
     spr.setTextDatum(MC_DATUM);
-    spr.drawString(option2, 170, 130);
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    drawText(option2, 170, 130);
 }
 
-void drawValueEditor(const char *title, float &value, const char *unit, float step, float maxVal) {
+void drawValueEditor(const char *title, float value, const char *unit, float step, float maxVal) {
     spr.fillSprite(TFT_BLACK);
     spr.setTextDatum(TC_DATUM);
     spr.setTextColor(TFT_WHITE, TFT_BLACK);
-    spr.loadFont(Noto);
-    spr.drawString(title, 120, 40);
-    spr.unloadFont();
-    spr.setTextDatum(MC_DATUM);
-    spr.loadFont(bigFont);
+    useFont(FONT_NOTO);
+    drawText(title, 120, 40);
     char buf[20];
     if (step < 0.1) sprintf(buf, "%.2f %s", value, unit);
     else sprintf(buf, "%.1f %s", value, unit);
-    spr.drawString(buf, 120, 120);
-    spr.unloadFont();
+    if (!drawBigText(buf, 120, 120, MC_DATUM, TFT_WHITE, TFT_BLACK)) {
+        spr.setTextDatum(MC_DATUM);
+        useFont(FONT_BIG);
+        drawText(buf, 120, 120);
+    }
     spr.setTextDatum(BC_DATUM);
-    spr.loadFont(Noto);
+    useFont(FONT_NOTO);
     spr.setTextColor(grays[5], TFT_BLACK);
-    spr.drawString("Click to Save", 120, 210);
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    drawText("Click to Save", 120, 210);
 }
 
 void drawTimeEditor() {
     spr.fillSprite(TFT_BLACK);
     spr.setTextDatum(TC_DATUM);
     spr.setTextColor(TFT_WHITE, TFT_BLACK);
-    spr.loadFont(Noto);
-    spr.drawString("Set Time", 120, 40);
-    spr.unloadFont();
-    int hours = timeSettingMinutes / 60;
-    int minutes = timeSettingMinutes % 60;
-    spr.setTextDatum(MC_DATUM);
-    spr.loadFont(bigFont);
+    useFont(FONT_NOTO);
+    drawText("Set Time", 120, 40);
+    int hours = view.timeSettingMinutes / 60;
+    int minutes = view.timeSettingMinutes % 60;
     char buf[20];
     sprintf(buf, "%02d:%02d", hours, minutes);
-    spr.drawString(buf, 120, 120);
-    spr.unloadFont();
+    if (!drawBigText(buf, 120, 120, MC_DATUM, TFT_WHITE, TFT_BLACK)) {
+        spr.setTextDatum(MC_DATUM);
+        useFont(FONT_BIG);
+        drawText(buf, 120, 120);
+    }
     spr.setTextDatum(BC_DATUM);
-    spr.loadFont(Noto);
+    useFont(FONT_NOTO);
     spr.setTextColor(grays[5], TFT_BLACK);
-    spr.drawString("Click to Save", 120, 210);
-    spr.unloadFont();
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+    drawText("Click to Save", 120, 210);
 }
 
 void drawLogGraph() {
     spr.fillSprite(TFT_BLACK);
-    int pad = 20;
-    float minVal = logData[0], maxVal = logData[0];
-    for (int i = 1; i < logDataPoints; i++) {
-        if (logData[i] < minVal) minVal = logData[i];
-        if (logData[i] > maxVal) maxVal = logData[i];
-    }
-    if (abs(maxVal - minVal) < 0.1) { maxVal += 5; minVal -= 5; }
-
+    int pad = graphPad;
     spr.drawLine(pad, pad, pad, 240 - pad, TFT_WHITE);
     spr.drawLine(pad, 240 - pad, 240 - pad, 240 - pad, TFT_WHITE);
+    if (!view.logValid) return;
+
+    float minVal = view.logMin, maxVal = view.logMax;
+    if (abs(maxVal - minVal) < 0.1) { maxVal += 5; minVal -= 5; }
+    float scale = (240 - 2 * pad) / (maxVal - minVal);
+    auto yOf = [&](float v) { return (int)((240 - pad) - (v - minVal) * scale); };
 
-    for (int i = 0; i < logDataPoints - 1; i++) {
-        float x1 = pad + map(i, 0, logDataPoints, 0, 240 - (2 * pad));
-        float y1 = (240 - pad) - map(logData[i] * 10, minVal * 10, maxVal * 10, 0, 240 - (2 * pad));
-        float x2 = pad + map(i + 1, 0, logDataPoints, 0, 240 - (2 * pad));
-        float y2 = (240 - pad) - map(logData[i + 1] * 10, minVal * 10, maxVal * 10, 0, 240 - (2 * pad));
-        spr.drawLine(x1, y1, x2, y2, TFT_GREEN);
+    // Each column's min..max behind the line of means
+    for (int c = 0; c < graphWidth; c++) {
+        int yLow = yOf(view.logLow[c]), yHigh = yOf(view.logHigh[c]);
+        if (yLow > yHigh) spr.drawFastVLine(pad + c, yHigh, yLow - yHigh + 1, TFT_DARKGREEN);
     }
-    float spY = (240 - pad) - map(data.setpoint * 10, minVal * 10, maxVal * 10, 0, 240 - (2 * pad));
+    int lastX = -1, lastY = 0;
+    for (int c = 0; c < graphWidth; c++) {
+        int y = yOf(view.logMean[c]);
+        if (lastX >= 0) spr.drawLine(lastX, lastY, pad + c, y, TFT_GREEN);
+        lastX = pad + c;
+        lastY = y;
+    }
+    int spY = yOf(view.data.setpoint);
     if(spY > pad && spY < (240-pad)) spr.drawFastHLine(pad, spY, 240-(2*pad), TFT_RED);
+}
 
-    M5Dial.Display.pushImage(0, 0, 240, 240, (uint16_t *)spr.getPointer());
+void drawDiagnostics() {
+    spr.fillSprite(TFT_BLACK);
+    useFont(FONT_NOTO);
+    spr.setTextDatum(TC_DATUM);
+    spr.setTextColor(TFT_WHITE, TFT_BLACK);
+    drawText("Diagnostics", 120, 30);
+
+    char buf[40];
+    spr.setTextColor(view.i2cConnected ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    if (view.zoneCount > 1) {
+        snprintf(buf, sizeof(buf), "Zone %d: %s", view.zone + 1, view.i2cConnected ? "OK" : "NO CONNECT");
+        drawText(buf, 120, 60);
+    } else {
+        drawText(view.i2cConnected ? "I2C: OK" : "I2C: NO CONNECT", 120, 60);
+    }
+    spr.setTextColor(grays[2], TFT_BLACK);
+    snprintf(buf, sizeof(buf), "Frames: %lu", framesRendered);
+    drawText(buf, 120, 84);
+    snprintf(buf, sizeof(buf), "Coalesced: %lu", (unsigned long)framesCoalesced.load());
+    drawText(buf, 120, 102);
+    snprintf(buf, sizeof(buf), "Max FPS: %d", UI_MAX_FPS);
+    drawText(buf, 120, 120);
+    snprintf(buf, sizeof(buf), "Frame: %lu us", lastFrameMicros);
+    drawText(buf, 120, 138);
+    snprintf(buf, sizeof(buf), "Poll: %lu ms  Bus: %lu.%lu%%", (unsigned long)view.pollIntervalMs,
+             (unsigned long)view.busPermille / 10, (unsigned long)view.busPermille % 10);
+    drawText(buf, 120, 156);
+    snprintf(buf, sizeof(buf), "Bad frames: %lu", (unsigned long)view.badFrames);
+    drawText(buf, 120, 174);
+
+    spr.setTextDatum(BC_DATUM);
+    spr.setTextColor(grays[5], TFT_BLACK);
+    drawText("Click to Exit", 120, 210);
+}
+
+// A ZoneLog in PSRAM, else in internal RAM if that leaves logHeapReserve
+// free; nullptr if neither.
+ZoneLog *newZoneLog() {
+    void *mem = heap_caps_malloc(sizeof(ZoneLog), MALLOC_CAP_SPIRAM);
+    if (!mem && heap_caps_get_free_size(MALLOC_CAP_8BIT) >= sizeof(ZoneLog) + logHeapReserve) {
+        mem = heap_caps_malloc(sizeof(ZoneLog), MALLOC_CAP_8BIT);
+    }
+    return mem ? new (mem) ZoneLog() : nullptr;
+}
+
+void deleteZoneLog(ZoneLog *log) {
+    if (!log) return;
+    log->~ZoneLog();
+    heap_caps_free(log);
+}
+
+void allocateLogs() {
+    for (int z = 0; z < zoneCount; z++) {
+        logData[z] = newZoneLog();
+        if (!logData[z]) {
+            Serial.printf("Zone %d: no memory for its log\n", z + 1);
+            continue;
+        }
+        logData[z]->fill(25.0);
+    }
 }
 
 void saveLocalSettings() {
@@ -575,15 +1591,576 @@ void loadLocalSettings() {
     if (timeSettingMinutes < 0 || timeSettingMinutes > (24*60)) timeSettingMinutes = 30;
 }
 
+// ================= TEST LOG =================
+
+void testLogPath(char *path, size_t n, uint16_t run) {
+    snprintf(path, n, TEST_LOG_DIR "/%05u", run);
+}
+
+uint16_t testPageCrc(const LogPage &page) {
+    LogPage p = page;
+    p.header.crc = 0;
+    return frameCrc((const uint8_t *)&p, sizeof(p));
+}
+
+// Pages of a run that was still open at boot: the whole pages in its file,
+// less the last one if it does not check out. Nothing else is read.
+uint32_t recoverTestRun(uint16_t run) {
+    char path[24];
+    testLogPath(path, sizeof(path), run);
+    if (!LittleFS.exists(path)) return 0;
+    File f = LittleFS.open(path, "r");
+    if (!f) return 0;
+    uint32_t pages = f.size() / TEST_LOG_PAGE_SIZE;
+    LogPage last;
+    if (pages > 0) {
+        bool ok = f.seek((pages - 1) * TEST_LOG_PAGE_SIZE) &&
+                  f.read((uint8_t *)&last, sizeof(last)) == sizeof(last) &&
+                  last.header.magic == TEST_LOG_MAGIC && last.header.run == run &&
+                  last.header.page == pages - 1 && last.header.crc == testPageCrc(last);
+        if (!ok) pages--;
+    }
+    f.close();
+    return pages;
+}
+
+// Mounts the filesystem and closes the runs a reset cut short, going by
+// the index alone.
+void beginTestLog() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("Test log: no filesystem");
+        return;
+    }
+    testLogReady = true;
+    if (!LittleFS.exists(TEST_LOG_DIR)) LittleFS.mkdir(TEST_LOG_DIR);
+    if (LittleFS.exists(TEST_LOG_INDEX ".tmp")) LittleFS.remove(TEST_LOG_INDEX ".tmp");   // a cut short prune
+    if (!LittleFS.exists(TEST_LOG_INDEX)) return;
+    File index = LittleFS.open(TEST_LOG_INDEX, "r+");
+    if (!index) return;
+    LogRunEntry e;
+    for (size_t at = 0; index.seek(at) && index.read((uint8_t *)&e, sizeof(e)) == sizeof(e); at += sizeof(e)) {
+        if (e.run >= nextTestRun) nextTestRun = e.run + 1;
+        if (e.flags & LOG_RUN_CLOSED) continue;
+        e.pages = recoverTestRun(e.run);
+        e.flags |= LOG_RUN_CLOSED;
+        index.seek(at);
+        index.write((const uint8_t *)&e, sizeof(e));
+    }
+    index.close();
+}
+
+// Deletes the oldest closed runs until the filesystem is back under
+// testLogMaxUsedPercent, rewriting the index without them.
+void pruneTestLog() {
+    auto full = [] { return LittleFS.usedBytes() * 100 > LittleFS.totalBytes() * testLogMaxUsedPercent; };
+    if (!full() || !LittleFS.exists(TEST_LOG_INDEX)) return;
+    File index = LittleFS.open(TEST_LOG_INDEX, "r");
+    File kept = LittleFS.open(TEST_LOG_INDEX ".tmp", "w");
+    if (!index || !kept) return;
+    LogRunEntry e;
+    char path[24];
+    while (index.read((uint8_t *)&e, sizeof(e)) == sizeof(e)) {
+        if ((e.flags & LOG_RUN_CLOSED) && full()) {
+            testLogPath(path, sizeof(path), e.run);
+            LittleFS.remove(path);
+        } else {
+            kept.write((const uint8_t *)&e, sizeof(e));
+        }
+    }
+    index.close();
+    kept.close();
+    LittleFS.rename(TEST_LOG_INDEX ".tmp", TEST_LOG_INDEX);
+}
+
+void writeTestRunEntry(const LogRunEntry &entry) {
+    File index = LittleFS.open(TEST_LOG_INDEX, LittleFS.exists(TEST_LOG_INDEX) ? "r+" : "w");
+    if (!index) return;
+    LogRunEntry e;
+    size_t at = 0;
+    while (index.read((uint8_t *)&e, sizeof(e)) == sizeof(e) && e.run != entry.run) at += sizeof(e);
+    index.seek(at);
+    index.write((const uint8_t *)&entry, sizeof(entry));
+    index.close();
+}
+
+// Appends the page being filled to the run's file and starts the next.
+void writeTestPage(TestRun &r) {
+    LogPageHeader &h = r.page.header;
+    h.crc = testPageCrc(r.page);
+    char path[24];
+    testLogPath(path, sizeof(path), r.run);
+    File f = LittleFS.open(path, "a");
+    if (f && f.write((const uint8_t *)&r.page, sizeof(r.page)) == sizeof(r.page)) {
+        f.flush();
+        h.page++;
+    } else {
+        Serial.printf("Test log: run %u page %lu not written\n", r.run, (unsigned long)h.page);
+    }
+    if (f) f.close();
+    h.count = 0;
+    memset(r.page.data, 0, sizeof(r.page.data));
+    r.encoder.reset();
+}
+
+void startTestRun(int zone, unsigned long now) {
+    pruneTestLog();
+    TestRun &r = testRuns[zone];
+    memset(&r.page, 0, sizeof(r.page));
+    r.open = true;
+    r.run = nextTestRun++;
+    r.startMs = now;
+    r.page.header.magic = TEST_LOG_MAGIC;
+    r.page.header.run = r.run;
+    r.page.header.zone = zone;
+    r.encoder.reset();
+    writeTestRunEntry({ r.run, (uint8_t)zone, 0, 0 });
+}
+
+void finishTestRun(int zone) {
+    TestRun &r = testRuns[zone];
+    if (r.page.header.count > 0) writeTestPage(r);
+    writeTestRunEntry({ r.run, (uint8_t)zone, LOG_RUN_CLOSED, r.page.header.page });
+    r.open = false;
+}
+
+// Once a second: a zone that starts a test or is asked to log opens a run,
+// gets a record per call while it lasts and closes the run when it stops.
+// A zone that drops off the bus keeps its run open and just misses records.
+void serviceTestLog(unsigned long now) {
+    if (!testLogReady) return;
+    for (int z = 0; z < zoneCount; z++) {
+        if (!zoneConnected[z]) continue;
+        const ControllerData &zd = zoneState(z);
+        TestRun &r = testRuns[z];
+        bool active = zd.isRunning || zd.isLogging;
+        if (active && !r.open) startTestRun(z, now);
+        if (!r.open) continue;
+        if (!active) { finishTestRun(z); continue; }
+
+        LogRecord rec;
+        rec.seconds = (now - r.startMs) / 1000;
+        rec.temp = (int16_t)lroundf(zd.currentTemp * 10);
+        rec.setpoint = (int16_t)lroundf(zd.setpoint * 10);
+        rec.output = (int16_t)lroundf(zd.output * 10);
+        rec.errorState = zd.errorState;
+        if (!r.encoder.append(r.page, rec)) {
+            writeTestPage(r);
+            r.encoder.append(r.page, rec);
+        }
+        if (r.page.header.count == 1) r.pageStartMs = now;
+        else if (now - r.pageStartMs >= TEST_LOG_PAGE_MAX_SECONDS * 1000UL) writeTestPage(r);
+    }
+}
+
 // ================= I2C =================
 
-void syncWithController() {
-    uint8_t received = Wire.requestFrom(I2C_ADDR_MAINBOARD, sizeof(ControllerData));
-    if (received == sizeof(ControllerData)) {
-        i2cConnected = true;
-        ControllerData incoming;
-        Wire.readBytes((uint8_t*)&incoming, sizeof(ControllerData));
+// I2C side: blocking transfers, only ever called from i2cStep().
+unsigned long i2cBusyUs = 0;    // time spent in transfers, for i2cBusPermille
+uint8_t frameSeq = 0;
+
+enum BusResult { BUS_OK, BUS_ERROR, BUS_CORRUPT };
+
+// Sends one frame; see FRAMING in SharedData.h.
+bool sendFrame(uint8_t addr, uint8_t reg, uint8_t len, const void *payload, bool stop) {
+    uint8_t frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    FrameHeader h = { CONTROLLER_PROTOCOL_VERSION, ++frameSeq, reg, len };
+    size_t n = (reg & FRAME_READ) ? 0 : len;
+    memcpy(frame, &h, sizeof(h));
+    if (n) memcpy(frame + sizeof(h), payload, n);
+    uint16_t crc = frameCrc(frame, sizeof(h) + n);
+    frame[sizeof(h) + n] = crc;
+    frame[sizeof(h) + n + 1] = crc >> 8;
+    Wire.beginTransmission(addr);
+    Wire.write(frame, sizeof(h) + n + 2);
+    return Wire.endTransmission(stop) == 0;
+}
+
+// Reads `len` bytes from `reg`. On BUS_OK `payload` points at them inside
+// the receive frame, valid until the next read, so callers can decode in
+// place.
+BusResult readFrame(uint8_t addr, uint8_t reg, size_t len, const uint8_t *&payload) {
+    static uint8_t frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    unsigned long t0 = micros();
+    size_t want = len + FRAME_OVERHEAD;
+    BusResult result = BUS_ERROR;
+    if (sendFrame(addr, reg | FRAME_READ, len, nullptr, false) &&
+        Wire.requestFrom(addr, want) == want &&
+        Wire.readBytes(frame, want) == want) {
+        FrameHeader h;
+        memcpy(&h, frame, sizeof(h));
+        uint16_t crc = frame[sizeof(h) + len] | (frame[sizeof(h) + len + 1] << 8);
+        result = (h.version == CONTROLLER_PROTOCOL_VERSION && h.seq == frameSeq && h.reg == reg &&
+                  h.len == len && crc == frameCrc(frame, sizeof(h) + len)) ? BUS_OK : BUS_CORRUPT;
+        if (result == BUS_CORRUPT) i2cBadFrames++;
+        payload = frame + sizeof(h);
+    }
+    i2cBusyUs += micros() - t0;
+    return result;
+}
+
+BusResult readRegisters(uint8_t addr, uint8_t reg, void *dst, size_t len) {
+    const uint8_t *payload;
+    BusResult result = readFrame(addr, reg, len, payload);
+    if (result == BUS_OK) memcpy(dst, payload, len);
+    return result;
+}
+
+BusResult writeRegisters(uint8_t addr, uint8_t reg, const void *src, size_t len) {
+    unsigned long t0 = micros();
+    bool ok = sendFrame(addr, reg, len, src, true);
+    i2cBusyUs += micros() - t0;
+    return ok ? BUS_OK : BUS_ERROR;
+}
+
+// I2C side state of one mainboard; controllers[0..zoneCount) are the zones
+// scanControllers() found.
+struct Controller {
+    uint8_t addr = I2C_ADDR_MAINBOARD;
+    ControllerData state = {};      // the mainboard's fields as last read
+    bool linkUp = false;
+    bool resync = false;            // read everything on the next poll
+    bool historyWanted = false;     // set on (re)connect, see serviceHistory()
+    bool dataReady = false;         // DRDY fell since the last poll
+    uint8_t commandSeq = 0;         // of the last command sent, from REG_ACK on connect
+    uint8_t failures = 0;           // polls failed in a row, see linkFailLimit
+    float slew = 0;                 // smoothed |dT/dt| in C/s
+    float lastTemp = 0;
+    unsigned long lastTempAt = 0;
+    unsigned long backoffMs = i2cPollMs;
+    unsigned long lastPoll = 0;
+};
+Controller controllers[maxZones];
+
+// Probes every mainboard address once at startup; each one that answers
+// becomes a zone. If none does, zone 0 stays at I2C_ADDR_MAINBOARD so the
+// dial shows NO CONNECT and keeps trying it.
+void scanControllers() {
+    zoneCount = 0;
+    for (int i = 0; i < maxZones; i++) {
+        Wire.beginTransmission(I2C_ADDR_MAINBOARD + i);
+        if (Wire.endTransmission() == 0) controllers[zoneCount++].addr = I2C_ADDR_MAINBOARD + i;
+    }
+    if (zoneCount == 0) zoneCount = 1;
+}
+
+// Brings c.state up to date with the mainboard: all of it after a
+// (re)connect, otherwise only the fields flagged in REG_CHANGED, one
+// transfer per run of neighbouring fields.
+BusResult readControllerState(Controller &c, bool full, bool &changed) {
+    uint16_t mask = (1 << CF_COUNT) - 1;
+    const uint8_t *payload;
+    if (!full) {
+        BusResult r = readFrame(c.addr, REG_CHANGED, 2, payload);
+        if (r != BUS_OK) return r;
+        mask = payload[0] | (payload[1] << 8);
+    }
+    changed = (mask != 0);
+    for (int f = 0; f < CF_COUNT; f++) {
+        if (!(mask & (1 << f))) continue;
+        int last = f;
+        while (last + 1 < CF_COUNT && (mask & (1 << (last + 1)))) last++;
+        uint8_t start = controllerFields[f].offset;
+        uint8_t len = controllerFields[last].offset + controllerFields[last].size - start;
+        BusResult r = readFrame(c.addr, REG_DATA + start, len, payload);
+        if (r != BUS_OK) return r;
+        for (int g = f; g <= last; g++) decodeField(c.state, (ControllerField)g, payload + controllerFields[g].offset - start);
+        f = last;
+    }
+    return BUS_OK;
+}
+
+// How long to wait before c's next timed poll.
+unsigned long pollInterval(const Controller &c) {
+    if (!c.linkUp) return c.backoffMs;
+    if (c.failures) return i2cPollMs;
+    if (CONTROLLER_DRDY_PIN >= 0) return i2cHeartbeatMs;
+    bool editing = i2cUserEditing.load() && &c == &controllers[i2cActiveZone.load()];
+    if (editing || (c.state.isRunning && c.slew > rampSlewCPerS)) return i2cFastPollMs;
+    if (c.state.isRunning || c.slew > stableSlewCPerS) return i2cPollMs;
+    return i2cIdlePollMs;
+}
+
+void trackSlew(Controller &c) {
+    unsigned long now = millis();
+    if (c.lastTempAt != 0 && now != c.lastTempAt) {
+        float rate = fabs(c.state.currentTemp - c.lastTemp) * 1000.0f / (now - c.lastTempAt);
+        c.slew = c.slew * 0.6f + rate * 0.4f;
+    }
+    c.lastTemp = c.state.currentTemp;
+    c.lastTempAt = now;
+}
+
+// Returns true if c's connection or data changed.
+bool pollController(Controller &c) {
+    bool &connected = c.linkUp;
+    bool wasConnected = connected;
+    bool changed = false;
+
+    if (!connected) {
+        uint8_t version = 0;
+        connected = readRegisters(c.addr, REG_VERSION, &version, 1) == BUS_OK && version == CONTROLLER_PROTOCOL_VERSION;
+        // Read the mask once so it only reports changes made from here on
+        const uint8_t *payload;
+        connected = connected && readFrame(c.addr, REG_CHANGED, 2, payload) == BUS_OK;
+        // Number new commands on from the last one the mainboard took, which
+        // may be from before a dial reboot; reusing its seq would get the
+        // next command dropped as a resend
+        connected = connected && readFrame(c.addr, REG_ACK, COMMAND_ACK_WIRE_SIZE, payload) == BUS_OK;
+        if (connected) c.commandSeq = decodeAck(payload).seq;
+    }
+    if (connected) {
+        bool full = !wasConnected || c.resync;
+        BusResult r = readControllerState(c, full, changed);
+        // A dropped reply may have carried changes REG_CHANGED no longer
+        // flags, so read everything next time. Only a run of failed
+        // transfers takes the link down, not one flaky one.
+        if (r == BUS_OK) {
+            c.failures = 0;
+            if (full) c.resync = false;
+        } else {
+            c.resync = true;
+            if (r == BUS_ERROR && ++c.failures >= linkFailLimit) connected = false;
+        }
+    }
+    if (connected) {
+        if (!wasConnected) {
+            c.historyWanted = true;
+            c.failures = 0;
+        }
+        trackSlew(c);
+        c.backoffMs = i2cPollMs;
+    } else {
+        c.backoffMs = min(c.backoffMs * 2, i2cMaxBackoffMs);
+    }
+    return connected != wasConnected || changed;
+}
+
+void publishPolls() {
+    I2cPoll &poll = i2cPolls.draft();
+    for (int z = 0; z < zoneCount; z++) {
+        poll.connected[z] = controllers[z].linkUp;
+        poll.data[z] = controllers[z].state;
+    }
+    i2cPolls.publish();
+}
+
+// Sends the command at the head of the queue and keeps checking REG_ACK,
+// resending the same frame every commandRetryMs, until it is acknowledged
+// or commandAttempts run out. A command for a zone whose link is down is
+// held for up to commandHoldMs until it reconnects, and gets its seq only
+// when first sent, from the zone's count. Returns true while there is
+// command work left.
+bool serviceCommands() {
+    static ZoneCommand zc;
+    static bool inFlight = false;
+    static int attempts = 0;
+    static unsigned long lastSend = 0, queuedAt = 0;
+    ControllerCommand &cmd = zc.cmd;
+
+    if (!inFlight) {
+        if (xQueueReceive(i2cCommands, &zc, 0) != pdTRUE) return false;
+        inFlight = true;
+        attempts = 0;
+        queuedAt = millis();
+    }
+    Controller &c = controllers[zc.zone];
+    if (attempts == 0) {
+        if (!c.linkUp) {
+            if (millis() - queuedAt < commandHoldMs) return true;
+            // Given up on; the dial's optimistic copy is put right on reconnect
+            c.resync = true;
+            inFlight = false;
+            return uxQueueMessagesWaiting(i2cCommands) > 0;
+        }
+        if (++c.commandSeq == 0) c.commandSeq = 1;
+        cmd.seq = c.commandSeq;
+    } else {
+        const uint8_t *payload;
+        CommandAck ack = {};
+        if (readFrame(c.addr, REG_ACK, COMMAND_ACK_WIRE_SIZE, payload) == BUS_OK) ack = decodeAck(payload);
+        bool acked = ack.seq == cmd.seq;
+        if (!acked && millis() - lastSend < commandRetryMs) return true;
+        if (acked || attempts == commandAttempts) {
+            // A refused or lost command leaves the dial's optimistic copy
+            // wrong; fetch what the mainboard really has
+            if (!acked || ack.status != CMD_OK) c.resync = true;
+            inFlight = false;
+            return uxQueueMessagesWaiting(i2cCommands) > 0;
+        }
+    }
+    uint8_t wire[COMMAND_WIRE_MAX];
+    writeRegisters(c.addr, REG_COMMAND, wire, encodeCommand(cmd, wire));
+    attempts++;
+    lastSend = millis();
+    return true;
+}
+
+// Downloads a newly connected zone's history, as far back as the tier its
+// graph shows reaches, and rolls it up into a ZoneLog handed to loop()
+// through i2cHistory. One page per call, so commands still get through in
+// between; once it has caught up with the samples taken meanwhile too.
+// Returns true while there is history work left.
+bool serviceHistory() {
+    static bool active = false;
+    static uint32_t next = 0, newest = 0;   // sample numbers
+    static int failures = 0;
+    static I2cHistory out = {};
+    const uint8_t *payload;
+
+    if (!active) {
+        // A zone stays wanted until its HistoryInfo reads back, or its link
+        // drops and the next connect asks again. It waits for a complete
+        // read of its state, which says how far back its graph goes.
+        int zone = 0;
+        while (zone < zoneCount && !(controllers[zone].historyWanted && controllers[zone].linkUp &&
+                                     !controllers[zone].resync)) zone++;
+        if (zone == zoneCount) return false;
+        const Controller &c = controllers[zone];
+        if (readFrame(c.addr, REG_HISTORY_INFO, HISTORY_INFO_WIRE_SIZE, payload) != BUS_OK) return true;
+        HistoryInfo info = decodeHistoryInfo(payload);
+        controllers[zone].historyWanted = false;
+        if (info.count == 0) return true;
+        out.zone = zone;
+        out.log = newZoneLog();
+        if (!out.log) return true;
+        uint32_t span = (uint32_t)logDataPoints * ZoneLog::bucketSeconds(ZoneLog::tierFor(c.state.testDuration));
+        uint32_t want = min((uint32_t)info.count, span);
+        newest = info.newest;
+        next = newest - want + 1;
+        failures = 0;
+        active = true;
+    }
+
+    Controller &c = controllers[out.zone];
+    if (!c.linkUp) {
+        // Asked for again on reconnect
+        deleteZoneLog(out.log);
+        active = false;
+        return false;
+    }
+    if (next > newest) {
+        // Samples taken since the download started come last
+        if (readFrame(c.addr, REG_HISTORY_INFO, HISTORY_INFO_WIRE_SIZE, payload) == BUS_OK &&
+            decodeHistoryInfo(payload).newest > newest) {
+            newest = decodeHistoryInfo(payload).newest;
+            return true;
+        }
+        if (xQueueSend(i2cHistory, &out, 0) != pdTRUE) deleteZoneLog(out.log);
+        active = false;
+        return false;
+    }
+    uint32_t n = min(newest - next + 1, (uint32_t)HISTORY_PAGE_SAMPLES);
+    uint8_t select[4];
+    putLe32(select, next);
+    uint32_t first = 0;
+    BusResult r = writeRegisters(c.addr, REG_HISTORY_SELECT, select, sizeof(select));
+    if (r == BUS_OK) r = readFrame(c.addr, REG_HISTORY, 4 + n * HISTORY_SAMPLE_WIRE_SIZE, payload);
+    if (r == BUS_OK) first = getLe32(payload);
+    if (r == BUS_OK && (first < next || first > newest)) r = BUS_CORRUPT;
+    if (r != BUS_OK) {
+        // A failed page is asked for again; after a run of them the whole
+        // download starts over
+        if (++failures == commandAttempts) {
+            deleteZoneLog(out.log);
+            c.historyWanted = true;
+            active = false;
+        }
+        return true;
+    }
+    failures = 0;
+    // Samples that left the ring meanwhile are skipped, the rest stays contiguous
+    n = min(n, newest - first + 1);
+    for (uint32_t i = 0; i < n; i++) {
+        out.log->push(decodeHistorySample(payload + 4 + i * HISTORY_SAMPLE_WIRE_SIZE).temp / 10.0f);
+    }
+    next = first + n;
+    return true;
+}
+
+// Services the command queue, or else the history download, then polls
+// the next zone round robin whose mainboard signalled new data or whose
+// poll is due; each zone keeps its own poll interval. Returns how many ms
+// until there is something to do.
+unsigned long i2cStep() {
+    static unsigned long windowStart = 0;
+    static int lastZone = 0;
+    bool busy = serviceCommands() || serviceHistory();
+    if (controllerDataReady.exchange(false)) {
+        // The line is shared, so any of them may have new data
+        for (int z = 0; z < zoneCount; z++) controllers[z].dataReady = true;
+    }
+    for (int i = 1; i <= zoneCount; i++) {
+        int z = (lastZone + i) % zoneCount;
+        Controller &c = controllers[z];
+        if (!c.dataReady && millis() - c.lastPoll < pollInterval(c)) continue;
+        c.dataReady = false;
+        c.lastPoll = millis();
+        if (pollController(c)) publishPolls();
+        busy = busy || (c.historyWanted && c.linkUp && !c.resync);
+        lastZone = z;
+        break;
+    }
+#if CONTROLLER_DRDY_PIN >= 0
+    // A zone that flagged new changes while the others were being read
+    // keeps the line low without another falling edge; once every zone has
+    // been read, go round again for as long as it stays low
+    static unsigned long lastSweep = 0;
+    bool swept = true;
+    for (int z = 0; z < zoneCount; z++) swept = swept && !controllers[z].dataReady;
+    if (swept && millis() - lastSweep >= i2cFastPollMs && digitalRead(CONTROLLER_DRDY_PIN) == LOW) {
+        lastSweep = millis();
+        for (int z = 0; z < zoneCount; z++) controllers[z].dataReady = controllers[z].linkUp;
+    }
+#endif
+
+    unsigned long now = millis();
+    if (now - windowStart >= 1000) {
+        i2cBusPermille = i2cBusyUs / (now - windowStart);
+        i2cBusyUs = 0;
+        windowStart = now;
+    }
+    i2cIntervalMs = pollInterval(controllers[i2cActiveZone.load()]);
+    unsigned long waitMs = i2cMaxBackoffMs;     // no interval is longer
+    for (int z = 0; z < zoneCount; z++) {
+        const Controller &c = controllers[z];
+        unsigned long interval = pollInterval(c), since = now - c.lastPoll;
+        waitMs = min(waitMs, c.dataReady || since >= interval ? 1 : interval - since);
+    }
+    return busy ? min(waitMs, commandRetryMs) : waitMs;
+}
 
+void IRAM_ATTR onControllerDataReady() {
+    controllerDataReady = true;
+#if I2C_TASK_CORE >= 0
+    if (!i2cTaskHandle) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(i2cTaskHandle, &woken);
+    if (woken) portYIELD_FROM_ISR();
+#endif
+}
+
+#if I2C_TASK_CORE >= 0
+void i2cTask(void *) {
+    for (;;) {
+        unsigned long waitMs = i2cStep();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    }
+}
+#endif
+
+// Loop side: applies the newest poll result, if one arrived since last time.
+void syncWithController() {
+    if (!i2cPolls.fetch()) return;
+    const I2cPoll &poll = i2cPolls.current();
+    for (int z = 0; z < zoneCount; z++) {
+        zoneConnected[z] = poll.connected[z];
+        if (z != activeZone && zoneConnected[z]) zoneData[z] = poll.data[z];
+    }
+    ControllerData before = data;
+    bool wasConnected = i2cConnected;
+    i2cConnected = poll.connected[activeZone];
+    if (i2cConnected) {
+        const ControllerData &incoming = poll.data[activeZone];
         data.currentTemp = incoming.currentTemp;
         data.output = incoming.output;
         data.errorState = incoming.errorState;
@@ -599,13 +2176,60 @@ void syncWithController() {
             data.kd = incoming.kd;
             data.isRunning = incoming.isRunning;
         }
-    } else {
-        i2cConnected = false;
     }
+
+    if (i2cConnected != wasConnected || memcmp(&before, &data, sizeof(ControllerData)) != 0) {
+        invalidate(MAIN_SCREEN);
+        invalidate(DIAGNOSTICS);
+    }
+}
+
+// Loop side: replaces the newest part of a zone's log, in every tier, with
+// the mainboard's history, which has no gaps from dial reboots or lost
+// links.
+void backfillLog(const I2cHistory &history) {
+    if (logData[history.zone]) logData[history.zone]->backfill(*history.log);
+    deleteZoneLog(history.log);
+    if (history.zone == activeZone) invalidate(LOG_GRAPH);
+}
+
+// The latest state of a zone; for the zone on screen that is `data`.
+ControllerData &zoneState(int zone) {
+    return zone == activeZone ? data : zoneData[zone];
+}
+
+// Puts another zone on screen. Its data is already cached, so this needs
+// no bus traffic.
+void selectZone(int zone) {
+    zoneData[activeZone] = data;
+    activeZone = zone;
+    data = zoneData[zone];
+    i2cConnected = zoneConnected[zone];
+    i2cActiveZone = zone;
+    wakeI2c();
+    invalidate(MAIN_SCREEN);
+    invalidate(LOG_GRAPH);
+    invalidate(DIAGNOSTICS);
+}
+
+// Queues a command for the zone on screen; returns at once.
+void sendCommand(CommandType type, float a, float b, float c) {
+    sendZoneCommand(activeZone, type, a, b, c);
+}
+
+void sendZoneCommand(int zone, CommandType type, float a, float b, float c) {
+    ZoneCommand zc;
+    zc.zone = zone;
+    zc.cmd.seq = 0;         // numbered by serviceCommands()
+    zc.cmd.type = type;
+    zc.cmd.args[0] = a; zc.cmd.args[1] = b; zc.cmd.args[2] = c;
+    if (xQueueSend(i2cCommands, &zc, 0) != pdTRUE) return;      // queue full, dropped
+    wakeI2c();
 }
 
-void sendToController() {
-    Wire.beginTransmission(I2C_ADDR_MAINBOARD);
-    Wire.write((uint8_t*)&data, sizeof(ControllerData));
-    Wire.endTransmission();
+// Loop side: makes the I2C task look at its queue and poll rate now.
+void wakeI2c() {
+#if I2C_TASK_CORE >= 0
+    if (i2cTaskHandle) xTaskNotifyGive(i2cTaskHandle);
+#endif
 }
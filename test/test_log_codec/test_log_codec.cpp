@@ -0,0 +1,176 @@
+// LogEncoder/LogDecoder round trips over the cases each code length covers.
+//   pio test -e native
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "../../src/TestLog.h"
+
+void setUp() {}
+void tearDown() {}
+
+static LogRecord record(uint32_t seconds, int temp, int setpoint, int output, int errorState = 0) {
+    LogRecord r;
+    r.seconds = seconds;
+    r.temp = temp;
+    r.setpoint = setpoint;
+    r.output = output;
+    r.errorState = errorState;
+    return r;
+}
+
+// Encodes records into as many pages as it takes, the way the dial fills
+// them, and checks that decoding every page gives them back in order.
+static void roundTrip(const std::vector<LogRecord> &records, std::vector<LogPage> &pages) {
+    LogEncoder encoder;
+    pages.clear();
+    for (const LogRecord &r : records) {
+        if (pages.empty() || !encoder.append(pages.back(), r)) {
+            pages.emplace_back();
+            memset(&pages.back(), 0, sizeof(LogPage));
+            encoder.reset();
+            TEST_ASSERT_TRUE_MESSAGE(encoder.append(pages.back(), r), "a record fits an empty page");
+        }
+    }
+    size_t i = 0;
+    for (const LogPage &page : pages) {
+        LogDecoder decoder(page);
+        LogRecord r;
+        int n = 0;
+        while (decoder.next(r)) {
+            TEST_ASSERT_TRUE_MESSAGE(i < records.size(), "more records decoded than encoded");
+            const LogRecord &e = records[i++];
+            TEST_ASSERT_EQUAL_UINT32(e.seconds, r.seconds);
+            TEST_ASSERT_EQUAL_INT(e.temp, r.temp);
+            TEST_ASSERT_EQUAL_INT(e.setpoint, r.setpoint);
+            TEST_ASSERT_EQUAL_INT(e.output, r.output);
+            TEST_ASSERT_EQUAL_INT(e.errorState, r.errorState);
+            n++;
+        }
+        TEST_ASSERT_EQUAL_INT(page.header.count, n);
+    }
+    TEST_ASSERT_EQUAL_INT(records.size(), i);
+}
+
+static void roundTrip(const std::vector<LogRecord> &records) {
+    std::vector<LogPage> pages;
+    roundTrip(records, pages);
+}
+
+void test_steady_run_hits_record_cap() {
+    // 5 bits a record, so the count runs out before the bits do
+    std::vector<LogRecord> records;
+    for (uint32_t t = 0; t < 600; t++) records.push_back(record(t, 1800, 1800, 250));
+    std::vector<LogPage> pages;
+    roundTrip(records, pages);
+    TEST_ASSERT_EQUAL_INT(3, pages.size());
+    TEST_ASSERT_EQUAL_INT(TEST_LOG_MAX_RECORDS, pages[0].header.count);
+    TEST_ASSERT_EQUAL_INT(TEST_LOG_MAX_RECORDS, pages[1].header.count);
+    TEST_ASSERT_EQUAL_INT(600 - 2 * TEST_LOG_MAX_RECORDS, pages[2].header.count);
+}
+
+void test_noisy_run_fills_pages() {
+    // Wide swings every second, so pages fill on bits well short of the cap
+    std::vector<LogRecord> records;
+    uint32_t rng = 7;
+    for (uint32_t t = 0; t < 2000; t++) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        records.push_back(record(t, 1000 + (int)(rng % 400), 1200, (int)(rng >> 20) % 1001));
+    }
+    std::vector<LogPage> pages;
+    roundTrip(records, pages);
+    TEST_ASSERT_TRUE(pages.size() > 2000 / TEST_LOG_MAX_RECORDS + 1);
+    for (size_t p = 0; p + 1 < pages.size(); p++) TEST_ASSERT_TRUE(pages[p].header.count < TEST_LOG_MAX_RECORDS);
+}
+
+void test_delta_code_boundaries() {
+    // Zigzag values either side of each code's limit: 4 bits, 8 bits, escape
+    const int deltas[] = { 0, 1, -1, 7, -8, 8, -9, 127, -128, 128, -129, 5000, -5000 };
+    std::vector<LogRecord> records;
+    int temp = 0, t = 0;
+    for (int d : deltas) {
+        temp += d;
+        records.push_back(record(t++, temp, -temp, d));
+    }
+    roundTrip(records);
+}
+
+void test_full_range_values() {
+    // Deltas that overflow int16, carried by the escape as the value itself
+    std::vector<LogRecord> records;
+    records.push_back(record(0, INT16_MIN, INT16_MAX, 0));
+    records.push_back(record(1, INT16_MAX, INT16_MIN, -1));
+    records.push_back(record(2, INT16_MIN, INT16_MIN, INT16_MAX));
+    records.push_back(record(3, 0, 0, INT16_MIN));
+    roundTrip(records);
+}
+
+void test_negative_values() {
+    // Below zero C (a cold start outside) and a falling output
+    std::vector<LogRecord> records;
+    for (int t = 0; t < 300; t++) records.push_back(record(t, -400 + t / 3, -50, -t % 7));
+    roundTrip(records);
+}
+
+void test_time_gaps() {
+    // Missed seconds (a lost link), a long gap, time going back, and
+    // seconds past 16 bits
+    const uint32_t times[] = { 0, 1, 2, 3, 5, 7, 9, 10, 74, 75, 76, 1000, 40, 41, 70000, 70001, 4000000000u, 4000000001u };
+    std::vector<LogRecord> records;
+    for (uint32_t t : times) records.push_back(record(t, 250, 800, 0));
+    roundTrip(records);
+}
+
+void test_error_state_changes() {
+    std::vector<LogRecord> records;
+    for (int t = 0; t < 100; t++) records.push_back(record(t, 500, 500, 0, (t / 10) % 2 ? 255 - t : 0));
+    roundTrip(records);
+}
+
+void test_failed_append_leaves_page() {
+    LogPage page;
+    memset(&page, 0, sizeof(page));
+    LogEncoder encoder;
+    uint32_t t = 0;
+    // Escapes on every field until one no longer fits
+    while (encoder.append(page, record(t * 100000, t % 2 ? 30000 : -30000, t % 2 ? -30000 : 30000, t % 2 ? 1000 : -1000, t % 2)))
+        t++;
+    LogPage before = page;
+    TEST_ASSERT_FALSE(encoder.append(page, record(t * 100000, 12345, -12345, 999, 3)));
+    TEST_ASSERT_TRUE(memcmp(&before, &page, sizeof(page)) == 0);
+    // and so does the encoder: a record that fits still follows on
+    LogRecord last = record((t - 1) * 100000, (t - 1) % 2 ? 30000 : -30000, (t - 1) % 2 ? -30000 : 30000,
+                            (t - 1) % 2 ? 1000 : -1000, (t - 1) % 2);
+    TEST_ASSERT_TRUE(encoder.append(page, last));
+    LogDecoder decoder(page);
+    LogRecord r;
+    for (uint32_t i = 0; i <= t; i++) TEST_ASSERT_TRUE(decoder.next(r));
+    TEST_ASSERT_EQUAL_UINT32(last.seconds, r.seconds);
+    TEST_ASSERT_EQUAL_INT(last.temp, r.temp);
+}
+
+void test_decoder_stops_at_end_of_data() {
+    // A count the data cannot hold (a bad page) ends at the data's end
+    LogPage page;
+    memset(&page, 0xFF, sizeof(page));
+    page.header.count = TEST_LOG_MAX_RECORDS;
+    LogDecoder decoder(page);
+    LogRecord r;
+    int n = 0;
+    while (decoder.next(r)) n++;
+    TEST_ASSERT_TRUE(n < TEST_LOG_MAX_RECORDS);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_run_hits_record_cap);
+    RUN_TEST(test_noisy_run_fills_pages);
+    RUN_TEST(test_delta_code_boundaries);
+    RUN_TEST(test_full_range_values);
+    RUN_TEST(test_negative_values);
+    RUN_TEST(test_time_gaps);
+    RUN_TEST(test_error_state_changes);
+    RUN_TEST(test_failed_append_leaves_page);
+    RUN_TEST(test_decoder_stops_at_end_of_data);
+    return UNITY_END();
+}
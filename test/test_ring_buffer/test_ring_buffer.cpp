@@ -0,0 +1,120 @@
+// RingBuffer's min()/max() against a linear scan of what it should hold.
+//   pio test -e native
+#include <unity.h>
+#include <stdint.h>
+#include <vector>
+#include "../../src/RingBuffer.h"
+
+void setUp() {}
+void tearDown() {}
+
+static uint32_t rng = 1;
+
+// The ring's extremes where it tracks them, else the scan's own
+template <bool Tracked> struct Scan {
+    template <typename R> static int min(const R &ring, int) { return ring.min(); }
+    template <typename R> static int max(const R &ring, int) { return ring.max(); }
+};
+template <> struct Scan<false> {
+    template <typename R> static int min(const R &, int lo) { return lo; }
+    template <typename R> static int max(const R &, int hi) { return hi; }
+};
+
+static int nextValue(int range) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return (int)(rng % range) - range / 2;
+}
+
+// Pushes `pushes` values from next() and after each one compares size,
+// contents, and min() and max() where tracked, with the last N values
+// pushed.
+template <int N, int Track, typename Next>
+static void checkAgainstScan(RingBuffer<int, N, Track> &ring, int pushes, Next next) {
+    std::vector<int> pushed;
+    for (int p = 0; p < pushes; p++) {
+        int v = next(p);
+        ring.push(v);
+        pushed.push_back(v);
+        int held = pushed.size() < N ? (int)pushed.size() : N;
+        TEST_ASSERT_EQUAL_INT(held, ring.size());
+        TEST_ASSERT_EQUAL_INT(held == N, ring.full());
+        int lo = pushed[pushed.size() - held], hi = lo;
+        for (int i = 0; i < held; i++) {
+            int e = pushed[pushed.size() - held + i];
+            TEST_ASSERT_EQUAL_INT(e, ring[i]);
+            if (e < lo) lo = e;
+            if (e > hi) hi = e;
+        }
+        TEST_ASSERT_EQUAL_INT(lo, Scan<Track & RING_MIN>::min(ring, lo));
+        TEST_ASSERT_EQUAL_INT(hi, Scan<Track & RING_MAX>::max(ring, hi));
+    }
+}
+
+void test_random_small_range() {
+    // Many repeats, so ties between equal values are exercised
+    RingBuffer<int, 7> ring;
+    checkAgainstScan(ring, 5000, [](int) { return nextValue(5); });
+}
+
+void test_random_wide_range() {
+    RingBuffer<int, 200> ring;
+    checkAgainstScan(ring, 20000, [](int) { return nextValue(100000); });
+}
+
+void test_single_slot() {
+    RingBuffer<int, 1> ring;
+    checkAgainstScan(ring, 100, [](int) { return nextValue(50); });
+}
+
+void test_monotonic_runs() {
+    // Rising runs fill the min queue, falling runs the max queue, to the
+    // full N before they wrap
+    RingBuffer<int, 16> ring;
+    checkAgainstScan(ring, 2000, [](int p) { return (p / 40) % 2 ? 1000 - p % 40 : p % 40; });
+}
+
+void test_sawtooth_wraps() {
+    // Period not a multiple of N, so extremes leave from every slot
+    RingBuffer<int, 10> ring;
+    checkAgainstScan(ring, 3000, [](int p) { return p % 13; });
+}
+
+void test_clear_and_reuse() {
+    RingBuffer<int, 9> ring;
+    checkAgainstScan(ring, 100, [](int) { return nextValue(20); });
+    ring.clear();
+    TEST_ASSERT_EQUAL_INT(0, ring.size());
+    checkAgainstScan(ring, 1000, [](int) { return nextValue(20); });
+}
+
+void test_min_only_max_only() {
+    // The queues evict independently, so each alone must still hold up
+    RingBuffer<int, 12, RING_MIN> lows;
+    checkAgainstScan(lows, 3000, [](int) { return nextValue(40); });
+    RingBuffer<int, 12, RING_MAX> highs;
+    checkAgainstScan(highs, 3000, [](int) { return nextValue(40); });
+    RingBuffer<int, 12, RING_PLAIN> plain;
+    checkAgainstScan(plain, 100, [](int) { return nextValue(40); });
+    TEST_ASSERT_TRUE(sizeof(plain) < sizeof(lows) && sizeof(lows) < sizeof(RingBuffer<int, 12>));
+}
+
+void test_copy_to() {
+    RingBuffer<int, 5> ring;
+    for (int i = 0; i < 12; i++) ring.push(i);
+    int out[5];
+    ring.copyTo(out);
+    for (int i = 0; i < 5; i++) TEST_ASSERT_EQUAL_INT(7 + i, out[i]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_random_small_range);
+    RUN_TEST(test_random_wide_range);
+    RUN_TEST(test_single_slot);
+    RUN_TEST(test_monotonic_runs);
+    RUN_TEST(test_sawtooth_wraps);
+    RUN_TEST(test_clear_and_reuse);
+    RUN_TEST(test_min_only_max_only);
+    RUN_TEST(test_copy_to);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+// TieredLog::backfill() against a log that had the same samples pushed live.
+//   pio test -e native
+#include <unity.h>
+#include <stdint.h>
+#include "../../src/TieredLog.h"
+
+void setUp() {}
+void tearDown() {}
+
+typedef TieredLog<200> Log;
+
+// Logs are too big for the stack
+static Log live, history, dial;
+
+static float sample(int s) { return 20 + (s % 97) * 0.5f - (s % 13); }
+
+static void checkTier(const Log::Tier &expected, const Log::Tier &actual) {
+    TEST_ASSERT_EQUAL_INT(expected.means.size(), actual.means.size());
+    for (int i = 0; i < expected.means.size(); i++) {
+        TEST_ASSERT_EQUAL_FLOAT(expected.lows[i], actual.lows[i]);
+        TEST_ASSERT_EQUAL_FLOAT(expected.highs[i], actual.highs[i]);
+        TEST_ASSERT_EQUAL_FLOAT(expected.means[i], actual.means[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(expected.seconds, actual.seconds);
+}
+
+void test_backfill_rolls_up_every_tier() {
+    // Over an hour: past tier 0's 200 s and tier 1's 2000 s, into tier 3
+    live = Log();
+    history = Log();
+    dial = Log();
+    dial.fill(25);
+    for (int s = 0; s < 4000; s++) {
+        live.push(sample(s));
+        history.push(sample(s));
+    }
+    dial.backfill(history);
+    for (int t = 0; t < Log::TIERS; t++) checkTier(live.tier(t), dial.tier(t));
+    TEST_ASSERT_EQUAL_INT(6, dial.tier(3).means.size());
+    TEST_ASSERT_EQUAL_FLOAT(live.tier(2).lows.min(), dial.tier(2).lows.min());
+    TEST_ASSERT_EQUAL_FLOAT(live.tier(2).highs.max(), dial.tier(2).highs.max());
+}
+
+void test_live_samples_continue_the_backfill() {
+    // The buckets being filled carry over, so later pushes roll up as if
+    // the history had been live all along
+    live = Log();
+    history = Log();
+    dial = Log();
+    dial.fill(25);
+    for (int s = 0; s < 1234; s++) {
+        live.push(sample(s));
+        history.push(sample(s));
+    }
+    dial.backfill(history);
+    for (int s = 1234; s < 2500; s++) {
+        live.push(sample(s));
+        dial.push(sample(s));
+    }
+    for (int t = 0; t < Log::TIERS; t++) checkTier(live.tier(t), dial.tier(t));
+}
+
+void test_backfill_keeps_older_buckets() {
+    // The dial logged longer than the history reaches: its older buckets
+    // stay, the newest are replaced
+    dial = Log();
+    history = Log();
+    for (int s = 0; s < 3000; s++) dial.push(1);
+    for (int s = 0; s < 300; s++) history.push(2);
+    dial.backfill(history);
+    const Log::Tier &t0 = dial.tier(0);
+    TEST_ASSERT_EQUAL_INT(200, t0.means.size());
+    TEST_ASSERT_EQUAL_FLOAT(2, t0.lows.min());
+    const Log::Tier &t1 = dial.tier(1);
+    TEST_ASSERT_EQUAL_INT(200, t1.means.size());
+    for (int i = 0; i < 170; i++) TEST_ASSERT_EQUAL_FLOAT(1, t1.means[i]);
+    for (int i = 170; i < 200; i++) TEST_ASSERT_EQUAL_FLOAT(2, t1.means[i]);
+    const Log::Tier &t2 = dial.tier(2);
+    TEST_ASSERT_EQUAL_INT(50, t2.means.size());
+    for (int i = 0; i < 45; i++) TEST_ASSERT_EQUAL_FLOAT(1, t2.means[i]);
+    for (int i = 45; i < 50; i++) TEST_ASSERT_EQUAL_FLOAT(2, t2.means[i]);
+    TEST_ASSERT_EQUAL_FLOAT(1, t2.lows.min());
+    TEST_ASSERT_EQUAL_FLOAT(2, t2.highs.max());
+    // Tier 3 has five old buckets and history none yet, only a part of one
+    const Log::Tier &t3 = dial.tier(3);
+    TEST_ASSERT_EQUAL_INT(5, t3.means.size());
+    TEST_ASSERT_EQUAL_INT(300, t3.seconds);
+}
+
+void test_short_history_keeps_the_fill() {
+    dial = Log();
+    history = Log();
+    dial.fill(25);
+    for (int s = 0; s < 50; s++) history.push(30);
+    dial.backfill(history);
+    const Log::Tier &t0 = dial.tier(0);
+    TEST_ASSERT_EQUAL_INT(200, t0.means.size());
+    TEST_ASSERT_EQUAL_FLOAT(25, t0.means[149]);
+    TEST_ASSERT_EQUAL_FLOAT(30, t0.means[150]);
+    TEST_ASSERT_EQUAL_INT(5, dial.tier(1).means.size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_backfill_rolls_up_every_tier);
+    RUN_TEST(test_live_samples_continue_the_backfill);
+    RUN_TEST(test_backfill_keeps_older_buckets);
+    RUN_TEST(test_short_history_keeps_the_fill);
+    return UNITY_END();
+}